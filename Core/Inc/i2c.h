@@ -37,10 +37,38 @@
 #define __I2C_H
 
 #include "stm32f10x.h"
+#include <stddef.h>
+
+/**
+ * ******************************************************************************
+ * Configuration Guide:
+ *
+ * I2C_TIMEOUT_LOOPS                polls of a status flag before a transfer is
+ *                                  abandoned with I2C_ERR_TIMEOUT. A poll is
+ *                                  approx 15 cycles at -O0, 10000 bound every
+ *                                  wait to approx 2ms at 72 MHz, well above
+ *                                  one byte at 100 kHz (90us)
+ *
+ * I2C_SLAVE_RX_SIZE                bytes of a write transfer kept by the
+ *                                  interrupt slave receiver, the ones past
+ *                                  it are acknowledged and counted as
+ *                                  dropped. At most 255.
+ * ******************************************************************************
+ */
+
 
 /* Own address used when in SLAVE mode */
 #define STM32F1_SLV_ADDR            ( 0x5C )
 
+#define I2C_TIMEOUT_LOOPS           10000
+
+#define I2C_SLAVE_RX_SIZE           160
+
+/* SCL range of i2c_set_speed(), i2c_init() starts at 100 kHz */
+#define I2C_SCL_MIN_HZ              10000UL
+#define I2C_SCL_STANDARD_HZ         100000UL
+#define I2C_SCL_FAST_HZ             400000UL
+
 
 typedef enum
 {
@@ -49,6 +77,57 @@ typedef enum
 } i2cMode_t;
 
 
+/* I2C peripheral used by i2c_transfer(), the drivers only use I2C1 */
+typedef enum
+{
+    I2C_BUS_1 = 0
+} i2cBus_t;
+
+
+/* Transfer addressed to STM32F1_SLV_ADDR, see i2c_slave_poll() */
+typedef enum
+{
+    I2C_SLAVE_IDLE = 0,         /* not addressed */
+    I2C_SLAVE_RX,               /* master writes, serve with i2c_read_burst(SLAVE, ...) */
+    I2C_SLAVE_TX                /* master reads, serve with i2c_write_burst(SLAVE, ...) */
+} i2cSlaveDir_t;
+
+
+/* Callbacks of the interrupt slave, see i2c_slave_irq_start(). Both run
+   in the I2C1 interrupt handlers and must be short */
+typedef struct
+{
+    /* A write transfer ended with a STOP or a repeated START. buf holds
+       the first len bytes, dropped counts the bytes that did not fit in
+       I2C_SLAVE_RX_SIZE (saturates at 255) */
+    void (*received)(const uint8_t *buf, uint8_t len, uint8_t dropped);
+
+    /* A read transfer starts, returns the bytes to send and their number
+       in len. 0xFF is sent once they are exhausted. The bytes must stay
+       valid until the transfer ends */
+    const uint8_t *(*transmit)(uint8_t *len);
+} i2cSlaveHooks_t;
+
+
+/* i2c_transfer() flags */
+#define I2C_XFER_NOSTOP             ( 1U << 0 )     /* keep the bus, next transfer repeats START */
+
+
+/* Result of a transfer. On an error the transfer has been ended already:
+   the error flag is cleared and a STOP issued (not after ARLO, the
+   hardware leaves master mode by itself) */
+typedef enum
+{
+    I2C_OK = 0,
+    I2C_ERR_TIMEOUT,            /* a flag did not come within I2C_TIMEOUT_LOOPS */
+    I2C_ERR_NACK,               /* address or data not acknowledged (AF) */
+    I2C_ERR_ARLO,               /* arbitration lost */
+    I2C_ERR_BERR,               /* misplaced START or STOP on the bus */
+    I2C_ERR_PARAM,              /* invalid argument */
+    I2C_ERR_BUS_STUCK           /* SDA still low after i2c_bus_recover() */
+} i2cStatus_t;
+
+
 
 /**
  * @brief    Initializes I2C1 and its GPIO
@@ -83,29 +162,31 @@ void i2c_stop(void);
  * @brief    This function is called after issuing a start condition,
  *           this initiates the communication to slave device.
  * @param    slave_addr_rw: pre-shifted slave address and pre-appended RnW bit
- * @retval   none
+ * @retval   I2C_OK, or the error that ended the transfer
  */
-void i2c_request(uint8_t slave_addr_rw);
+i2cStatus_t i2c_request(uint8_t slave_addr_rw);
 
 
 
 /**
  * @brief    Transmit a byte of data
  * @param    data: 1 byte data to be transmitted
- * @retval   none
+ * @retval   I2C_OK, or the error that ended the transfer
  */
-void i2c_write(uint8_t data);
+i2cStatus_t i2c_write(uint8_t data);
 
 
 
 /**
  * @brief    Transmit a N byte of data
  * @param    mode: MASTER or SLAVE transmitter
- * @param    data_bytes: number of bytes to transmit
+ * @param    data_bytes: number of bytes to transmit. When in SLAVE mode
+ *                       the master reads until it NACKs, 0xFF is sent
+ *                       once data_buffer is exhausted.
  * @param    data_buffer: pointer to array where data are stored
- * @retval   none
+ * @retval   I2C_OK, or the error that ended the transfer
  */
-void i2c_write_burst(i2cMode_t mode, uint8_t data_bytes, uint8_t *data_buffer);
+i2cStatus_t i2c_write_burst(i2cMode_t mode, uint8_t data_bytes, uint8_t *data_buffer);
 
 
 
@@ -114,10 +195,10 @@ void i2c_write_burst(i2cMode_t mode, uint8_t data_bytes, uint8_t *data_buffer);
  *           Note: Stop condition is not required to call explicitly
  *           after each call to this function. This receiving sequence
  *           handles it already.
- * @param    none
- * @retval   1 byte of data from slave
+ * @param    data: receives 1 byte of data from slave
+ * @retval   I2C_OK, or the error that ended the transfer
  */
-uint8_t i2c_read(void);
+i2cStatus_t i2c_read(uint8_t *data);
 
 
 
@@ -128,11 +209,153 @@ uint8_t i2c_read(void);
  *           handles it already.
  * @param    mode: MASTER or SLAVE receiver
  * @param    data_bytes: number of bytes to receive. When in SLAVE mode
- *                       this parameter is ignored.
+ *                       this parameter is the size of data_buffer, the
+ *                       reception ends at the STOP or at a repeated
+ *                       START, see i2c_slave_count().
  * @param    data_buffer: pointer to array where data will be stored
+ * @retval   I2C_OK, I2C_ERR_PARAM when data_bytes is less than 2 in
+ *           MASTER mode, or the error that ended the transfer
+ */
+i2cStatus_t i2c_read_burst(i2cMode_t mode, uint8_t data_bytes, uint8_t *data_buffer);
+
+
+
+/**
+ * @brief    Check without blocking whether a master addressed this MCU at
+ *           STM32F1_SLV_ADDR. Enables ACK so the address is acknowledged.
+ *           The master is held, SCL stretched, until the transfer is
+ *           served with i2c_read_burst() or i2c_write_burst() in SLAVE
+ *           mode.
+ * @param    none
+ * @retval   I2C_SLAVE_IDLE, I2C_SLAVE_RX when the master writes,
+ *           I2C_SLAVE_TX when it reads
+ */
+i2cSlaveDir_t i2c_slave_poll(void);
+
+
+
+/**
+ * @brief    Get the number of bytes moved by the last slave transfer
+ * @param    none
+ * @retval   bytes received and kept, or bytes transmitted
+ */
+uint8_t i2c_slave_count(void);
+
+
+
+/**
+ * @brief    Serve transfers addressed to STM32F1_SLV_ADDR from the I2C1
+ *           event and error interrupts instead of i2c_slave_poll(). Each
+ *           byte costs one short interrupt, SCL is stretched while it is
+ *           pending, so bursts at 400 kHz leave the main loop running.
+ *           The interrupts are masked while this MCU is master, from
+ *           i2c_start() to i2c_stop(); a START waits for a slave transfer
+ *           in progress to end first.
+ * @param    hooks: callbacks, must stay valid
+ * @retval   none
+ */
+void i2c_slave_irq_start(const i2cSlaveHooks_t *hooks);
+
+
+
+/**
+ * @brief    Stop the interrupt slave, addressed transfers are left to
+ *           i2c_slave_poll() again
+ * @param    none
+ * @retval   none
+ */
+void i2c_slave_irq_stop(void);
+
+
+
+/**
+ * @brief    Hold back the interrupt slave while thread mode reads or
+ *           updates data shared with the hooks. A transfer in progress is
+ *           stretched meanwhile, keep the section short and do not start
+ *           a master transfer inside it.
+ * @param    none
+ * @retval   none
+ */
+void i2c_slave_irq_lock(void);
+
+
+
+/**
+ * @brief    End a section started with i2c_slave_irq_lock()
+ * @param    none
  * @retval   none
  */
-void i2c_read_burst(i2cMode_t mode, uint8_t data_bytes, uint8_t *data_buffer);
+void i2c_slave_irq_unlock(void);
+
+
+
+/**
+ * @brief    Combined transfer: write txlen bytes, read rxlen bytes, or
+ *           write then read with a repeated START, all under a single
+ *           arbitration. With both lengths 0 only the address is sent,
+ *           which probes for a device.
+ * @param    bus: I2C_BUS_1
+ * @param    addr: 7-bit slave address
+ * @param    tx: bytes to write, may be NULL when txlen is 0
+ * @param    txlen: number of bytes to write
+ * @param    rx: receives the bytes read, may be NULL when rxlen is 0
+ * @param    rxlen: number of bytes to read, 0-255
+ * @param    flags: I2C_XFER_NOSTOP to keep the bus after a write-only
+ *                  transfer, the next transfer then starts with a
+ *                  repeated START. Reads always end with a STOP.
+ * @retval   I2C_OK, I2C_ERR_PARAM, or the error that ended the transfer
+ */
+i2cStatus_t i2c_transfer(i2cBus_t bus, uint8_t addr, const uint8_t *tx, size_t txlen,
+                         uint8_t *rx, size_t rxlen, uint8_t flags);
+
+
+
+/**
+ * @brief    Change the SCL frequency. I2C1 is disabled while CCR and
+ *           TRISE are written, call it between transfers only. Up to
+ *           100 kHz standard mode is used, above it fast mode with a
+ *           2:1 duty cycle; the divider rounds towards a lower frequency.
+ *           i2c_init() and i2c_bus_recover() go back to 100 kHz.
+ * @param    hz: I2C_SCL_MIN_HZ to I2C_SCL_FAST_HZ
+ * @retval   I2C_OK, I2C_ERR_PARAM when hz is out of range
+ */
+i2cStatus_t i2c_set_speed(uint32_t hz);
+
+
+
+/**
+ * @brief    Get the SCL frequency last set
+ * @param    none
+ * @retval   SCL frequency in Hz
+ */
+uint32_t i2c_get_speed(void);
+
+
+
+/**
+ * @brief    Probe every address from first to last with an address-only
+ *           write and collect the ones that acknowledge. An absent
+ *           device costs one address byte and a STOP (about 0.1ms at
+ *           100 kHz), every probe is bounded by I2C_TIMEOUT_LOOPS.
+ * @param    first: first 7-bit address
+ * @param    last: last 7-bit address, at most 0x7F
+ * @param    found: receives the addresses that acknowledged, may be NULL
+ * @param    size: number of addresses found can hold
+ * @retval   number of addresses that acknowledged, at most size
+ */
+uint8_t i2c_scan(uint8_t first, uint8_t last, uint8_t *found, uint8_t size);
+
+
+
+/**
+ * @brief    Release a bus held low by a slave that lost track of a
+ *           transfer (e.g. a reset in the middle of a read). SCL is
+ *           clocked up to 9 times as GPIO until the slave releases SDA,
+ *           followed by a STOP, then I2C1 is reset and configured again.
+ * @param    none
+ * @retval   I2C_OK, I2C_ERR_BUS_STUCK when SDA is still held low
+ */
+i2cStatus_t i2c_bus_recover(void);
 
 
 #endif
\ No newline at end of file
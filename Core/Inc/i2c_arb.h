@@ -0,0 +1,126 @@
+/**
+  ******************************************************************************
+  * @file    i2c_arb.h
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Priority arbiter for devices sharing I2C1 with the LCD.
+  *
+  *          Time-critical devices register a job once, then mark it
+  *          pending with i2c_arb_request(), from thread mode or from any
+  *          interrupt handler. Pending jobs run in thread mode:
+  *
+  *          - from i2c_arb_service() in the main loop,
+  *          - between two chunks of LCD_BUS_CHUNK bytes of a long LCD
+  *            transaction, which the LCD driver closes and reopens around
+  *            them,
+  *          - before each single-byte LCD transaction and inside the LCD
+  *            delays.
+  *
+  *          A job therefore waits at most one LCD chunk instead of a whole
+  *          repaint. Jobs run in registration order, which is their
+  *          priority, at 100 kHz.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+#ifndef __I2C_ARB_H
+#define __I2C_ARB_H
+
+#include <stdint.h>
+#include "i2c.h"
+
+
+/**
+ * ******************************************************************************
+ * Configuration Guide:
+ *
+ * I2C_ARB_MAX_JOBS                 number of jobs that can be registered
+ * ******************************************************************************
+ */
+
+
+#define I2C_ARB_MAX_JOBS            4
+
+
+typedef struct i2cArbJob
+{
+    /* Transfer, see i2c_transfer() */
+    uint8_t addr;
+    const uint8_t *tx;
+    uint8_t txlen;
+    uint8_t *rx;
+    uint8_t rxlen;
+
+    /* Called in thread mode after the transfer, may be NULL */
+    void (*done)(struct i2cArbJob *job);
+
+    /* Result of the last run */
+    i2cStatus_t status;
+
+    /* Set by i2c_arb_request(), cleared when the job runs */
+    volatile uint8_t pending;
+} i2cArbJob_t;
+
+
+
+/**
+ * @brief    Register a job, jobs registered first have the higher
+ *           priority. Call from thread mode during initialization.
+ * @param    job: job, must stay valid
+ * @retval   1 if registered, 0 if I2C_ARB_MAX_JOBS are registered
+ */
+uint8_t i2c_arb_register(i2cArbJob_t *job);
+
+
+
+/**
+ * @brief    Mark a registered job pending. Safe to call from any
+ *           interrupt priority, a job already pending runs once.
+ * @param    job: registered job
+ * @retval   none
+ */
+void i2c_arb_request(i2cArbJob_t *job);
+
+
+
+/**
+ * @brief    Check for pending jobs
+ * @param    none
+ * @retval   1 if a job is pending, 0 otherwise
+ */
+uint8_t i2c_arb_pending(void);
+
+
+
+/**
+ * @brief    Run every pending job, highest priority first. Must not be
+ *           called with a transaction open on the bus.
+ * @param    none
+ * @retval   none
+ */
+void i2c_arb_service(void);
+
+
+#endif /* __I2C_ARB_H */
@@ -0,0 +1,142 @@
+/**
+  ******************************************************************************
+  * @file    i2c_capture.h
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Optional recorder of the I2C master transactions issued through
+  *          i2c_start(), i2c_request(), i2c_write(), i2c_read() and
+  *          i2c_stop(), for replay on the host (build/host/lcdreplay).
+  *
+  *          Every event is a 2-byte record, tag and data, kept in a RAM
+  *          ring of I2C_CAPTURE_SIZE bytes. When the ring is full the
+  *          oldest records are overwritten and counted as lost.
+  *
+  *          i2c_capture_export() writes the file format read by lcdreplay:
+  *
+  *          offset 0   "I2CC"
+  *          offset 4   version (1), then 3 reserved bytes
+  *          offset 8   number of records, uint32_t little-endian
+  *          offset 12  records lost, uint32_t little-endian
+  *          offset 16  records, oldest first
+  *
+  *          Get it off the target by sending the buffer over a UART or
+  *          from gdb, e.g. "dump binary memory cap.bin buf buf+len".
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+#ifndef __I2C_CAPTURE_H
+#define __I2C_CAPTURE_H
+
+#include <stdint.h>
+
+
+/**
+ * ******************************************************************************
+ * Configuration Guide:
+ *
+ * Setting macro to 1 enables it, 0 otherwise
+ *
+ * USE_I2C_CAPTURE                  record the I2C master transactions
+ * I2C_CAPTURE_SIZE                 ring size in bytes, power of two, two
+ *                                  bytes per record
+ * ******************************************************************************
+ */
+
+
+#define USE_I2C_CAPTURE             0
+#define I2C_CAPTURE_SIZE            2048
+
+
+/* Export file header */
+#define I2C_CAPTURE_MAGIC           "I2CC"
+#define I2C_CAPTURE_VERSION         1
+#define I2C_CAPTURE_HEADER_LEN      16
+
+
+/* Record tags */
+typedef enum
+{
+    I2C_CAP_START = 'S',        /* START or repeated START */
+    I2C_CAP_ADDR = 'A',         /* address byte, data = address + RnW */
+    I2C_CAP_WRITE = 'W',        /* data byte written */
+    I2C_CAP_READ = 'R',         /* data byte read */
+    I2C_CAP_STOP = 'P'          /* STOP */
+} i2cCaptureTag_t;
+
+
+
+#if ( USE_I2C_CAPTURE )
+
+#define I2C_CAPTURE(tag, data)      i2c_capture_record( (tag), (uint8_t)(data) )
+
+
+
+/**
+ * @brief    Drop every record and start recording
+ * @param    none
+ * @retval   none
+ */
+void i2c_capture_start(void);
+
+
+
+/**
+ * @brief    Stop recording, the records are kept
+ * @param    none
+ * @retval   none
+ */
+void i2c_capture_stop(void);
+
+
+
+/**
+ * @brief    Add a record while recording, used by I2C_CAPTURE
+ * @param    tag: record tag
+ * @param    data: record data
+ * @retval   none
+ */
+void i2c_capture_record(i2cCaptureTag_t tag, uint8_t data);
+
+
+
+/**
+ * @brief    Write the header and the records, oldest first, to buf
+ * @param    buf: destination
+ * @param    size: size of buf, at most I2C_CAPTURE_HEADER_LEN +
+ *                 I2C_CAPTURE_SIZE bytes are needed, newer records that
+ *                 do not fit are left out
+ * @retval   bytes written, 0 when buf cannot hold the header
+ */
+uint32_t i2c_capture_export(uint8_t *buf, uint32_t size);
+
+#else
+
+#define I2C_CAPTURE(tag, data)
+
+#endif
+
+
+#endif /* __I2C_CAPTURE_H */
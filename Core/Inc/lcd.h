@@ -39,6 +39,7 @@
 
 #include "stm32f10x.h"
 #include <stdint.h>
+#include <stddef.h>
 
 
 /**
@@ -59,7 +60,13 @@
  * Setting macro to 1 enables it, 0 otherwise
  *
  * USE_LCD_I2C                      set this to 1 to drive the LCD with I2C
- * LCD_SLAVE_ADDR                   7-bit I2C address, default is 0x27
+ * LCD_SLAVE_ADDR                   7-bit I2C address, default is 0x27, used
+ *                                  until lcd_discover() finds the displays
+ * LCD_MAX_DISPLAYS                 displays lcd_discover() can set up
+ * LCD_BUS_CHUNK                    PCF8574 writes a transaction makes before
+ *                                  it gives the bus to pending i2c_arb jobs,
+ *                                  one write is 9 SCL clocks, a character 4
+ *                                  writes
  * ******************************************************************************
  */
 
@@ -70,9 +77,20 @@
 
     #define LCD_SLAVE_ADDR          0x27
     #define LCD_SLAVE_W_ADDR        ( LCD_SLAVE_ADDR << 1 )
+    #define LCD_MAX_DISPLAYS        4
+    #define LCD_BUS_CHUNK           16
 
 #endif
 
+/* i2cStatus_t of lcd_bus_status(), also when bit banging */
+#include "i2c.h"
+
+/* Characters each DDRAM line holds, 16 of them are on the display */
+#define LCD_DDRAM_COLS              40
+
+/* lcd_shift() once a bus error left the display shift unknown */
+#define LCD_SHIFT_UNKNOWN           0xFF
+
 
 
 /* LCD APIs */
@@ -96,9 +114,20 @@ void lcd_clear(void);
 
 
 /**
- * @brief    LCD Function to move the cursor on the display
+ * @brief    LCD function to set the cursor to row 1, col 1 and undo the
+ *           display shift, DDRAM is left as it is
+ * @param    none
+ * @retval   none
+ */
+void lcd_home(void);
+
+
+
+/**
+ * @brief    LCD Function to move the cursor on the display. Nothing is sent
+ *           when the address counter is already at the requested position.
  * @param    row: First row (1), second row (2)
- * @param    col: any value from 1-16
+ * @param    col: 1-40, only 16 columns are on screen, see lcd_shift()
  * @retval   none
  */
 void lcd_goto_xy(uint8_t row, uint8_t col);
@@ -116,6 +145,17 @@ void lcd_display_ctrl(uint8_t display, uint8_t cursor, uint8_t blinking);
 
 
 
+/**
+ * @brief    LCD function to set the entry mode applied after each character
+ * @param    increment: Move the cursor to the right (1) or to the left (0)
+ * @param    shift    : Shift the entire display with each character (1) or not (0),
+ *                      opposite to the cursor. lcd_shift() follows it.
+ * @retval   none
+ */
+void lcd_entry_mode(uint8_t increment, uint8_t shift);
+
+
+
 /**
  * @brief    LCD function to print a string of characters to LCD
  * @param    str: pointer to array of characters
@@ -125,6 +165,55 @@ void lcd_print_string(char *str);
 
 
 
+/**
+ * @brief    LCD function to print len characters starting at row, col.
+ *           The characters are sent straight from buf in a single bus
+ *           transaction, buf does not need to be null terminated.
+ * @param    row: First row (1), second row (2)
+ * @param    col: 1-40, only 16 columns are on screen, see lcd_shift()
+ * @param    buf: pointer to the characters
+ * @param    len: number of characters to print
+ * @retval   none, nothing is written when row or col is out of range
+ */
+void lcd_write(uint8_t row, uint8_t col, const uint8_t *buf, size_t len);
+
+
+
+/**
+ * @brief    LCD function to start collecting the following LCD calls into
+ *           a single bus transaction, until the matching lcd_batch_end().
+ *           Calls may be nested. Does nothing when bit banging.
+ *           Pending i2c_arb jobs still get the bus after every
+ *           LCD_BUS_CHUNK writes.
+ * @param    none
+ * @retval   none
+ */
+void lcd_batch_begin(void);
+
+
+
+/**
+ * @brief    LCD function to close the bus transaction opened by the
+ *           outermost lcd_batch_begin()
+ * @param    none
+ * @retval   none
+ */
+void lcd_batch_end(void);
+
+
+
+/**
+ * @brief    LCD function to define one of the 8 custom characters, printed
+ *           afterwards as character codes 0-7. The cursor position is lost,
+ *           call lcd_goto_xy() before printing again.
+ * @param    index: character code 0-7
+ * @param    pattern: 8 rows top to bottom, 5 pixels in bits 4-0
+ * @retval   none
+ */
+void lcd_cgram(uint8_t index, const uint8_t *pattern);
+
+
+
 /**
  * @brief    LCD function to shift the entire display
  * @param    dir: To the right (1), to the left (0)
@@ -134,15 +223,118 @@ void lcd_shift_display(uint8_t dir);
 
 
 
+/**
+ * @brief    LCD function to get the display shift, moved by
+ *           lcd_shift_display() and by each character printed with the
+ *           entry mode shift on
+ * @param    none
+ * @retval   DDRAM column 0-39 shown at the left edge, LCD_SHIFT_UNKNOWN
+ *           after a bus error until lcd_home() or lcd_clear()
+ */
+uint8_t lcd_shift(void);
+
+
+
+/**
+ * @brief    LCD function to get the first I2C error since the previous
+ *           call and clear it. Every LCD call is bounded and returns even
+ *           with the display unplugged; after an error the LCD may have
+ *           lost its 4-bit nibble sync, call lcd_init() once this
+ *           returns I2C_OK again.
+ * @param    none
+ * @retval   I2C_OK, or the first error. Always I2C_OK when bit banging.
+ */
+i2cStatus_t lcd_bus_status(void);
+
+
+
 #if ( USE_LCD_I2C )
 
 /**
- * @brief    LCD function to turn on/off the backlight
+ * @brief    LCD function to turn on/off the backlight. The new state is
+ *           carried by the next transfer to the LCD, call lcd_flush() to
+ *           apply it when nothing else is going to be written.
  * @param    state: Off (0), On (1)
  * @retval   none
  */
 void lcd_backlight(uint8_t state);
 
+
+
+/**
+ * @brief    LCD function to write a pending backlight change that has not
+ *           been carried by any other transfer yet
+ * @param    none
+ * @retval   none
+ */
+void lcd_flush(void);
+
+
+
+/**
+ * @brief    LCD function to find every PCF8574 and PCF8574A backpack on
+ *           the bus and initialize a display for each, in address order.
+ *           Absent addresses only cost an address byte, the scan takes
+ *           about 2ms at 100 kHz. Display 0 is selected afterwards.
+ * @param    none
+ * @retval   number of displays found, at most LCD_MAX_DISPLAYS. On 0 the
+ *           display at LCD_SLAVE_ADDR is kept.
+ */
+uint8_t lcd_discover(void);
+
+
+
+/**
+ * @brief    LCD function to direct the following LCD calls to another
+ *           display. Not allowed inside lcd_batch_begin()/lcd_batch_end().
+ * @param    index: 0 up to the count returned by lcd_discover() - 1
+ * @retval   1 on success, 0 when there is no such display
+ */
+uint8_t lcd_select(uint8_t index);
+
+
+
+/**
+ * @brief    LCD function to get the address of the selected display
+ * @param    none
+ * @retval   7-bit I2C address
+ */
+uint8_t lcd_address(void);
+
+
+
+/**
+ * @brief    LCD function to set the SCL frequency used for the selected
+ *           display, see lcd_calibrate() to find the highest reliable one
+ * @param    hz: I2C_SCL_MIN_HZ to I2C_SCL_FAST_HZ
+ * @retval   1 on success, 0 when hz is out of range
+ */
+uint8_t lcd_set_speed(uint32_t hz);
+
+
+
+/**
+ * @brief    LCD function to get the SCL frequency of the selected display
+ * @param    none
+ * @retval   SCL frequency in Hz
+ */
+uint32_t lcd_speed(void);
+
+
+
+/**
+ * @brief    LCD function to read len characters back from DDRAM starting
+ *           at row, col. D7-D4 of PCF8574 are set high so the LCD can
+ *           drive them, then each nibble is read while EN is high. Not
+ *           allowed inside lcd_batch_begin()/lcd_batch_end().
+ * @param    row: First row (1), second row (2)
+ * @param    col: 1-40, only 16 columns are on screen, see lcd_shift()
+ * @param    buf: receives the characters
+ * @param    len: number of characters to read
+ * @retval   1 on success, 0 on a bus error or inside a batch
+ */
+uint8_t lcd_read(uint8_t row, uint8_t col, uint8_t *buf, size_t len);
+
 #endif
 
 
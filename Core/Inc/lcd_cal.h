@@ -0,0 +1,104 @@
+/**
+  ******************************************************************************
+  * @file    lcd_cal.h
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   SCL calibration of the I2C displays. lcd_calibrate() raises the
+  *          SCL of the selected display through 100, 200, 300 and 400 kHz,
+  *          writes test patterns to the off-screen DDRAM (0x18-0x27) at
+  *          each step and reads them back through the PCF8574. The
+  *          highest rate that passes is used for the display and kept in
+  *          the last flash page, lcd_cal_load() applies it after a reset.
+  *
+  *          The page holds one 16-bit record per calibration, address in
+  *          the upper byte and rate in 10 kHz units in the lower byte,
+  *          appended until the page is full. The latest record of an
+  *          address wins.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+#ifndef __LCD_CAL_H
+#define __LCD_CAL_H
+
+#include "lcd.h"
+
+
+/**
+ * ******************************************************************************
+ * Configuration Guide:
+ *
+ * Setting macro to 1 enables it, 0 otherwise
+ *
+ * USE_LCD_CAL                      calibrate displays without a stored rate
+ *                                  at boot and apply the stored ones. Each
+ *                                  calibration clears the display and
+ *                                  writes the flash page.
+ *
+ * LCD_CAL_PAGE_ADDR                flash page holding the rates, the last
+ *                                  1KB page of the 64KB part, which the
+ *                                  linker script keeps free
+ * LCD_CAL_PAGE_SIZE                size of the page in bytes
+ * ******************************************************************************
+ */
+
+
+#define USE_LCD_CAL                 0
+
+#ifndef LCD_CAL_PAGE_ADDR
+#define LCD_CAL_PAGE_ADDR           0x0800FC00UL
+#endif
+
+#define LCD_CAL_PAGE_SIZE           1024
+
+
+
+#if ( USE_LCD_I2C )
+
+/**
+ * @brief    Find the highest SCL frequency the selected display accepts
+ *           reliably, use it for the display and store it in flash. The
+ *           display is initialized again, and so cleared, after a failed
+ *           step. The cursor is left at row 1, col 1.
+ * @param    none
+ * @retval   SCL frequency in Hz, 0 when even 100 kHz fails (nothing is
+ *           stored then). The rate is used even when the flash could
+ *           not be programmed.
+ */
+uint32_t lcd_calibrate(void);
+
+
+
+/**
+ * @brief    Apply the stored SCL frequency of the selected display
+ * @param    none
+ * @retval   1 when a rate was stored for its address, 0 otherwise
+ */
+uint8_t lcd_cal_load(void);
+
+#endif
+
+
+#endif /* __LCD_CAL_H */
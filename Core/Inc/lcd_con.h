@@ -0,0 +1,108 @@
+/**
+  ******************************************************************************
+  * @file    lcd_con.h
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Text console from USART1 to the LCD.
+  *
+  *          USART1 (PA9 TX, PA10 RX) receives into a circular buffer
+  *          through DMA1 channel 5, no interrupt per character. The only
+  *          interrupt is IDLE, raised when the line stays quiet for one
+  *          character after a message. lcd_con_process() draws what
+  *          arrived through the terminal or frame parser into the shadow
+  *          framebuffer and flushes it at the end
+  *          of each message, or every LCD_CON_FLUSH_CHARS characters of
+  *          a stream that does not pause. Characters overwritten before a
+  *          flush never reach the LCD, so the console keeps up with input
+  *          faster than the display.
+  *
+  *          The input is a VT100/ANSI stream, see lcd_term.h for the
+  *          control codes and escape sequences, or with USE_LCD_CON_FRAMES
+  *          binary frames, see lcd_frame.h.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+#ifndef __LCD_CON_H
+#define __LCD_CON_H
+
+#include "lcd.h"
+#include "lcd_term.h"
+#include "lcd_frame.h"
+
+
+/**
+ * ******************************************************************************
+ * Configuration Guide:
+ *
+ * Setting macro to 1 enables it, 0 otherwise
+ *
+ * USE_LCD_CONSOLE                  run main() as a USART1 text console
+ * USE_LCD_CON_FRAMES               parse the input as lcd_frame.h frames
+ *                                  instead of VT100 text
+ *
+ * LCD_CON_BAUD                     USART1 baud rate, PCLK2 is 72 MHz
+ *
+ * LCD_CON_RX_SIZE                  circular receive buffer. lcd_con_process()
+ *                                  must run before it fills up: 512 bytes
+ *                                  last 44ms at 115200 baud, several full
+ *                                  repaints at 100 kHz.
+ *
+ * LCD_CON_FLUSH_CHARS              characters of a stream without pause
+ *                                  drawn between two flushes
+ * ******************************************************************************
+ */
+
+
+#define USE_LCD_CONSOLE             0
+#define USE_LCD_CON_FRAMES          0
+
+#define LCD_CON_BAUD                115200UL
+#define LCD_CON_RX_SIZE             512
+#define LCD_CON_FLUSH_CHARS         64
+
+
+
+/**
+ * @brief    Clear the console and start receiving, USART1 8N1 at
+ *           LCD_CON_BAUD
+ * @param    none
+ * @retval   none
+ */
+void lcd_con_init(void);
+
+
+
+/**
+ * @brief    Draw the characters received since the last call and flush
+ *           the framebuffer at the end of a message. Call it from the
+ *           main loop.
+ * @param    none
+ * @retval   number of characters drawn
+ */
+uint16_t lcd_con_process(void);
+
+
+#endif /* __LCD_CON_H */
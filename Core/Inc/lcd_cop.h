@@ -0,0 +1,141 @@
+/**
+  ******************************************************************************
+  * @file    lcd_cop.h
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Display co-processor. A host master on I2C1 addresses this MCU at
+  *          STM32F1_SLV_ADDR and writes a register map: framebuffer, display
+  *          control, cursor and CGRAM glyphs. The MCU renders the changes
+  *          to the LCD afterwards, so an update costs the host one short
+  *          transfer instead of the HD44780 nibble timing.
+  *
+  *          A write transfer is the register address followed by data, the
+  *          address auto-increments. A read transfer returns the map from
+  *          the register address of the last write, e.g. write 0x00 then
+  *          read STATUS with a repeated START.
+  *
+  *          The LCD hangs off the same bus, the MCU masters it between
+  *          host transfers. A host transfer arriving while the MCU waits
+  *          for its own START wins, the LCD transfer is dropped and
+  *          retried (see i2c_request()). Hosts should address only the
+  *          co-processor, not the LCD backpacks.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+#ifndef __LCD_COP_H
+#define __LCD_COP_H
+
+#include "i2c.h"
+#include "lcd.h"
+#include "lcd_fb.h"
+
+
+/**
+ * ******************************************************************************
+ * Configuration Guide:
+ *
+ * Setting macro to 1 enables it, 0 otherwise
+ *
+ * USE_LCD_COP                      run main() as a display co-processor
+ * USE_LCD_COP_IRQ                  serve the host master from the I2C1
+ *                                  interrupts, see i2c_slave_irq_start(),
+ *                                  instead of lcd_cop_poll()
+ * ******************************************************************************
+ */
+
+
+#define USE_LCD_COP                 0
+#define USE_LCD_COP_IRQ             1
+
+
+/* Register map */
+#define LCD_COP_STATUS              0x00    /* R   LCD_COP_ST_* bits, write 1 clears ERROR/OVERRUN */
+#define LCD_COP_CTRL                0x01    /* R/W LCD_COP_CTRL_* bits */
+#define LCD_COP_CMD                 0x02    /* W   LCD_COP_CMD_* */
+#define LCD_COP_CURSOR              0x03    /* R/W cursor DDRAM address, row 1 0x00-0x0F, row 2 0x40-0x4F */
+#define LCD_COP_FB                  0x10    /* R/W framebuffer, LCD_FB_COLS bytes per row */
+#define LCD_COP_CGRAM               0x40    /* R/W 8 glyphs of 8 rows, pixels in bits 4-0 */
+#define LCD_COP_MAP_SIZE            0x80
+
+/* STATUS bits */
+#define LCD_COP_ST_BUSY             ( 1U << 0 )     /* an update waits to be rendered */
+#define LCD_COP_ST_ERROR            ( 1U << 1 )     /* rendering hit a bus error, it is retried */
+#define LCD_COP_ST_OVERRUN          ( 1U << 2 )     /* a write went past the map and was dropped */
+
+/* CTRL bits */
+#define LCD_COP_CTRL_DISPLAY        ( 1U << 0 )
+#define LCD_COP_CTRL_CURSOR         ( 1U << 1 )
+#define LCD_COP_CTRL_BLINK          ( 1U << 2 )
+#define LCD_COP_CTRL_BACKLIGHT      ( 1U << 3 )
+
+/* CMD values */
+#define LCD_COP_CMD_CLEAR           0x01    /* fill the framebuffer with spaces */
+#define LCD_COP_CMD_INIT            0x02    /* initialize the LCD again and repaint everything */
+
+
+
+/**
+ * @brief    Reset the register map, the framebuffer is cleared, the display
+ *           and backlight are on. With USE_LCD_COP_IRQ the interrupt
+ *           slave starts serving the host.
+ * @param    none
+ * @retval   none
+ */
+void lcd_cop_init(void);
+
+
+
+/**
+ * @brief    Serve a pending transfer from the host master, if any. Polled
+ *           transport, call it often from the main loop when
+ *           USE_LCD_COP_IRQ is 0.
+ * @param    none
+ * @retval   none
+ */
+void lcd_cop_poll(void);
+
+
+
+/**
+ * @brief    Apply a write transfer to the register map, used by the
+ *           transport. Runs in the I2C1 interrupt with USE_LCD_COP_IRQ.
+ * @param    buf: register address followed by the data
+ * @param    len: bytes in buf
+ * @retval   none
+ */
+void lcd_cop_receive(const uint8_t *buf, uint8_t len);
+
+
+
+/**
+ * @brief    Render the changes written since the last call to the LCD
+ * @param    none
+ * @retval   none
+ */
+void lcd_cop_process(void);
+
+
+#endif /* __LCD_COP_H */
@@ -0,0 +1,156 @@
+/**
+  ******************************************************************************
+  * @file    lcd_fb.h
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Shadow framebuffer of the 16x2 display. Writes only change RAM,
+  *          lcd_fb_flush() compares the framebuffer with what the LCD
+  *          shows and sends the changed runs, in one bus transaction when
+  *          driven by I2C.
+  *
+  *          A single unchanged character between two changed ones is sent
+  *          again instead of moving the cursor, both cost one LCD
+  *          instruction.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+#ifndef __LCD_FB_H
+#define __LCD_FB_H
+
+#include "lcd.h"
+
+
+#define LCD_FB_ROWS                 2
+#define LCD_FB_COLS                 16
+
+/* lcdFbState_t parts sent by lcd_fb_render() besides glyphs and cursor */
+#define LCD_FB_SEND_CTRL            ( 1U << 0 )     /* display, cursor and blink */
+#define LCD_FB_SEND_BACKLIGHT       ( 1U << 1 )     /* backlight, I2C only */
+
+
+/* Display state drawn around the framebuffer by lcd_fb_render() */
+typedef struct
+{
+    const uint8_t *cgram;       /* 8 glyphs of 8 rows, pixels in bits 4-0 */
+    uint8_t glyphs;             /* glyphs to upload, bit n for character code n */
+    uint8_t send;               /* LCD_FB_SEND_* parts to send */
+    uint8_t display;            /* display on (1) or off (0) */
+    uint8_t cursor;             /* underline cursor on (1) or off (0) */
+    uint8_t blink;              /* blinking block on (1) or off (0) */
+    uint8_t backlight;          /* back light on (1) or off (0) */
+    uint8_t row;                /* cursor position while the cursor or the */
+    uint8_t col;                /* block shows, 1-based */
+} lcdFbState_t;
+
+
+
+/**
+ * @brief    Fill the framebuffer with spaces and invalidate it, the first
+ *           flush then clears the whole display
+ * @param    none
+ * @retval   none
+ */
+void lcd_fb_init(void);
+
+
+
+/**
+ * @brief    Write len characters starting at row, col, clipped at the end
+ *           of the row
+ * @param    row: First row (1), second row (2)
+ * @param    col: any value from 1-16
+ * @param    buf: pointer to the characters
+ * @param    len: number of characters
+ * @retval   none
+ */
+void lcd_fb_write(uint8_t row, uint8_t col, const uint8_t *buf, size_t len);
+
+
+
+/**
+ * @brief    Set every character of the framebuffer
+ * @param    ch: character, ' ' clears
+ * @retval   none
+ */
+void lcd_fb_fill(uint8_t ch);
+
+
+
+/**
+ * @brief    Get a character of the framebuffer
+ * @param    row: First row (1), second row (2)
+ * @param    col: any value from 1-16
+ * @retval   character, ' ' outside the display
+ */
+uint8_t lcd_fb_get(uint8_t row, uint8_t col);
+
+
+
+/**
+ * @brief    Forget what the LCD shows so the next flush sends everything.
+ *           Call after lcd_init(), lcd_clear() or prints that bypass the
+ *           framebuffer.
+ * @param    none
+ * @retval   none
+ */
+void lcd_fb_invalidate(void);
+
+
+
+/**
+ * @brief    Check for changes not sent to the LCD yet
+ * @param    none
+ * @retval   1 when a flush is needed, 0 otherwise
+ */
+uint8_t lcd_fb_pending(void);
+
+
+
+/**
+ * @brief    Send the characters that differ from what the LCD shows. A
+ *           bus error (see lcd_bus_status(), consumed here) invalidates
+ *           the framebuffer so the next flush repaints.
+ * @param    none
+ * @retval   number of characters sent
+ */
+uint16_t lcd_fb_flush(void);
+
+
+
+/**
+ * @brief    Render a display state in the order the LCD needs it: glyphs,
+ *           framebuffer changes, display control, back light, then the
+ *           cursor is put back where drawing moved it from. Consumes
+ *           lcd_bus_status().
+ * @param    state: what to send
+ * @param    sent: receives the number of characters sent, may be NULL
+ * @retval   1 when everything reached the LCD, 0 after a bus error. The
+ *           framebuffer repaints itself, the rest is up to the caller.
+ */
+uint8_t lcd_fb_render(const lcdFbState_t *state, uint16_t *sent);
+
+
+#endif /* __LCD_FB_H */
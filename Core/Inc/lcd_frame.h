@@ -0,0 +1,163 @@
+/**
+  ******************************************************************************
+  * @file    lcd_frame.h
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Binary framed display updates for a remote link (UART, I2C
+  *          slave).
+  *
+  *          Frame:
+  *
+  *          0xA5  TYPE  LEN  PAYLOAD[LEN]  CRC_H  CRC_L
+  *
+  *          CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over TYPE, LEN
+  *          and the payload, LEN at most LCD_FRAME_MAX_PAYLOAD. A cell
+  *          position is ( row - 1 ) * LCD_FB_COLS + ( col - 1 ), cells
+  *          continue on the next row and writes past the last one are
+  *          dropped.
+  *
+  *          TYPE                PAYLOAD
+  *          0x01 CELLS          pos, characters
+  *          0x02 RLE            pos, then count/character pairs
+  *          0x03 CGRAM          glyph 0-7, 8 rows with pixels in bits 4-0
+  *          0x04 CTRL           LCD_FRAME_CTRL_* bits [, cursor pos]
+  *          0x05 BACKLIGHT      0 off, 1 on
+  *
+  *          The parser takes the stream a byte at a time and applies a
+  *          frame only once its CRC checks, cells go to the shadow
+  *          framebuffer (lcd_fb.h). On a bad CRC or length it hunts for
+  *          the next 0xA5. lcd_frame_flush() sends the result to the LCD,
+  *          unchanged cells cost nothing: a changed reading on a dashboard
+  *          is one 7-byte CELLS frame instead of a resent line.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+#ifndef __LCD_FRAME_H
+#define __LCD_FRAME_H
+
+#include "lcd.h"
+#include "lcd_fb.h"
+
+
+/**
+ * ******************************************************************************
+ * Configuration Guide:
+ *
+ * LCD_FRAME_MAX_PAYLOAD            largest payload accepted, a longer LEN is
+ *                                  treated as a framing error
+ * ******************************************************************************
+ */
+
+
+#define LCD_FRAME_MAX_PAYLOAD       64
+
+
+#define LCD_FRAME_SOF               0xA5
+
+/* Frame types */
+#define LCD_FRAME_CELLS             0x01
+#define LCD_FRAME_RLE               0x02
+#define LCD_FRAME_CGRAM             0x03
+#define LCD_FRAME_CTRL              0x04
+#define LCD_FRAME_BACKLIGHT         0x05
+
+/* CTRL bits */
+#define LCD_FRAME_CTRL_DISPLAY      ( 1U << 0 )
+#define LCD_FRAME_CTRL_CURSOR       ( 1U << 1 )
+#define LCD_FRAME_CTRL_BLINK        ( 1U << 2 )
+
+
+
+/**
+ * @brief    Reset the parser and the display state: framebuffer cleared,
+ *           display and backlight on, cursor off
+ * @param    none
+ * @retval   none
+ */
+void lcd_frame_init(void);
+
+
+
+/**
+ * @brief    Feed a byte of the stream to the parser
+ * @param    byte: received byte
+ * @retval   none
+ */
+void lcd_frame_putc(uint8_t byte);
+
+
+
+/**
+ * @brief    Feed len bytes of the stream to the parser
+ * @param    buf: received bytes
+ * @param    len: number of bytes
+ * @retval   none
+ */
+void lcd_frame_write(const uint8_t *buf, size_t len);
+
+
+
+/**
+ * @brief    Check for applied frames not shown on the LCD yet
+ * @param    none
+ * @retval   1 when a flush is needed, 0 otherwise
+ */
+uint8_t lcd_frame_pending(void);
+
+
+
+/**
+ * @brief    Send the applied frames to the LCD: glyphs, changed cells,
+ *           display control, backlight and cursor. What failed on the bus
+ *           is sent again by the next flush.
+ * @param    none
+ * @retval   number of characters sent
+ */
+uint16_t lcd_frame_flush(void);
+
+
+
+/**
+ * @brief    Get the number of frames rejected for a bad CRC, length or
+ *           type since lcd_frame_init()
+ * @param    none
+ * @retval   rejected frames
+ */
+uint16_t lcd_frame_errors(void);
+
+
+
+/**
+ * @brief    Update a CRC-16/CCITT-FALSE with a byte, start from 0xFFFF.
+ *           Also for senders building frames.
+ * @param    crc: CRC so far
+ * @param    byte: next byte
+ * @retval   updated CRC
+ */
+uint16_t lcd_frame_crc(uint16_t crc, uint8_t byte);
+
+
+#endif /* __LCD_FRAME_H */
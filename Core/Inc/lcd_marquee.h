@@ -0,0 +1,115 @@
+/**
+  ******************************************************************************
+  * @file    lcd_marquee.h
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Ticker that scrolls texts of any length across the display,
+  *          paced by TIM2.
+  *
+  *          The 40 DDRAM columns of each line hold the visible 16
+  *          characters of the text and the ones around them. A step shifts
+  *          the display one column (see lcd_view.h), then writes the next
+  *          character into the column that just went off screen. A step
+  *          costs one shift instruction and at most one character per row,
+  *          and no character at all when that column already holds the
+  *          right one.
+  *
+  *          The TIM2 interrupt only counts steps. They are drawn in thread
+  *          mode by lcd_marquee_process(), which never waits for the next
+  *          step, the main loop stays free for other work.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+#ifndef __LCD_MARQUEE_H
+#define __LCD_MARQUEE_H
+
+#include "lcd.h"
+#include "lcd_view.h"
+
+
+/**
+ * ******************************************************************************
+ * Configuration Guide:
+ *
+ * LCD_MARQUEE_STEP_MS              time between two steps, 1-6553 ms
+ *
+ * LCD_MARQUEE_GAP                  spaces between the end of a text and its
+ *                                  next repetition
+ *
+ * LCD_MARQUEE_CATCHUP              late steps drawn one by one, a main loop
+ *                                  further behind redraws both lines at
+ *                                  the current position instead
+ * ******************************************************************************
+ */
+
+
+#define LCD_MARQUEE_STEP_MS         250
+#define LCD_MARQUEE_GAP             4
+#define LCD_MARQUEE_CATCHUP         16
+
+
+
+/**
+ * @brief    Show the texts from their first character and start TIM2
+ * @param    row1: text of the first row, NULL leaves the row blank. Must
+ *           stay valid until lcd_marquee_stop().
+ * @param    row2: text of the second row, NULL leaves the row blank
+ * @param    dir: text moves to the right (1), to the left (0)
+ * @retval   none
+ */
+void lcd_marquee_start(const char *row1, const char *row2, uint8_t dir);
+
+
+
+/**
+ * @brief    Stop TIM2. The display keeps its shift, lcd_clear() or
+ *           lcd_view_set(1) undo it.
+ * @param    none
+ * @retval   none
+ */
+void lcd_marquee_stop(void);
+
+
+
+/**
+ * @brief    Draw the steps TIM2 counted since the last call. Call it from
+ *           the main loop. A bus error is repaired by the next step.
+ * @param    none
+ * @retval   number of steps drawn
+ */
+uint16_t lcd_marquee_process(void);
+
+
+
+/**
+ * @brief    Get the number of steps drawn since lcd_marquee_start()
+ * @param    none
+ * @retval   steps
+ */
+uint32_t lcd_marquee_steps(void);
+
+
+#endif /* __LCD_MARQUEE_H */
@@ -0,0 +1,94 @@
+/**
+  ******************************************************************************
+  * @file    lcd_num.h
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Numeric field widget for the 1602 LCD driver. A field remembers
+  *          the characters it last rendered and only rewrites the cells
+  *          that change, the conversion uses no division.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#ifndef __LCD_NUM_H
+#define __LCD_NUM_H
+
+#include <stdint.h>
+
+
+/* Widest field, sign + 10 digits + decimal point */
+#define LCD_NUM_MAX_WIDTH           12
+
+
+typedef struct
+{
+    uint8_t row;
+    uint8_t col;
+    uint8_t width;
+    uint8_t frac;
+    uint8_t shown[LCD_NUM_MAX_WIDTH];
+} lcdNum_t;
+
+
+
+/**
+ * @brief    Initialize a right aligned numeric field. Nothing is written
+ *           until the first lcd_num_set().
+ * @param    num: field to initialize
+ * @param    row: First row (1), second row (2)
+ * @param    col: column of the leftmost cell, 1-16
+ * @param    width: number of cells, 1 to LCD_NUM_MAX_WIDTH
+ * @param    frac: digits after the decimal point, 0 for an integer field
+ * @retval   none
+ */
+void lcd_num_init(lcdNum_t *num, uint8_t row, uint8_t col, uint8_t width, uint8_t frac);
+
+
+
+/**
+ * @brief    Render a value into the field, only the cells that differ
+ *           from the previous value are sent to the LCD. A value that
+ *           does not fit is shown as '#' in every cell. A bus error (see
+ *           lcd_bus_status(), consumed here) invalidates the field so
+ *           the next call rewrites every cell.
+ * @param    num: field to update
+ * @param    value: value to show, scaled by 10^frac
+ * @retval   none
+ */
+void lcd_num_set(lcdNum_t *num, int32_t value);
+
+
+
+/**
+ * @brief    Forget what the field shows so the next lcd_num_set() rewrites
+ *           every cell, e.g. after lcd_clear()
+ * @param    num: field to invalidate
+ * @retval   none
+ */
+void lcd_num_invalidate(lcdNum_t *num);
+
+
+#endif /* __LCD_NUM_H */
@@ -0,0 +1,78 @@
+/**
+  ******************************************************************************
+  * @file    lcd_printf.h
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Formatted printing for the 1602 LCD driver without the C library
+  *          formatted I/O, the heap or an intermediate buffer.
+  *
+  *          Format: %[flags][width][.precision]conversion
+  *
+  *          flags       -  left align within width
+  *                      0  pad numbers with zeros instead of spaces
+  *          precision   maximum characters for %s, decimal places for %q
+  *          conversion  d i u  signed / unsigned decimal
+  *                      x X    lower / upper case hexadecimal
+  *                      q      signed fixed-point, the argument is the value
+  *                             scaled by 10^precision (1234 with %.2q = 12.34)
+  *                      c s %  character, string (NULL prints (null)),
+  *                             literal %
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#ifndef __LCD_PRINTF_H
+#define __LCD_PRINTF_H
+
+#include <stdint.h>
+#include <stdarg.h>
+
+
+
+/**
+ * @brief    Print formatted text starting at row, col in a single bus
+ *           transaction. Output past the 40 character DDRAM line is dropped.
+ * @param    row: First row (1), second row (2)
+ * @param    col: any value from 1-16
+ * @param    fmt: format string, see lcd_printf.h for the conversions
+ * @retval   none
+ */
+void lcd_printf(uint8_t row, uint8_t col, const char *fmt, ...);
+
+
+
+/**
+ * @brief    lcd_printf() taking a va_list
+ * @param    row: First row (1), second row (2)
+ * @param    col: any value from 1-16
+ * @param    fmt: format string, see lcd_printf.h for the conversions
+ * @param    args: arguments for fmt
+ * @retval   none
+ */
+void lcd_vprintf(uint8_t row, uint8_t col, const char *fmt, va_list args);
+
+
+#endif /* __LCD_PRINTF_H */
@@ -0,0 +1,157 @@
+/**
+  ******************************************************************************
+  * @file    lcd_prof.h
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Optional DWT cycle counter profiling of the LCD and I2C driver
+  *          hot paths.
+  *
+  *          Each probe point keeps the number of calls, min, max and sum of
+  *          the CYCCNT deltas and a log2 histogram in lcd_prof[], which can
+  *          be read from a debugger (e.g. "p lcd_prof" in gdb) or by the
+  *          application. Times are inclusive: lcd_cmd contains its two
+  *          lcd_data_line calls, which contain their lcd_i2c_cmd calls, and
+  *          so on.
+  *
+  *          With USE_LCD_PROFILING set to 0 the probes compile to nothing.
+  *          Probes are not reentrant, the drivers are only called from one
+  *          context.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+#ifndef __LCD_PROF_H
+#define __LCD_PROF_H
+
+#include <stdint.h>
+
+
+/**
+ * ******************************************************************************
+ * Configuration Guide:
+ *
+ * Setting macro to 1 enables it, 0 otherwise
+ *
+ * USE_LCD_PROFILING                record CYCCNT deltas of the probe points
+ * LCD_PROF_BUCKETS                 histogram buckets, bucket n counts deltas
+ *                                  of 2^n to 2^(n+1)-1 cycles, the last one
+ *                                  everything above
+ * ******************************************************************************
+ */
+
+
+#define USE_LCD_PROFILING           0
+#define LCD_PROF_BUCKETS            24
+
+
+/* DWT registers, core_cm3.h of this CMSIS version has no DWT block */
+#ifndef LCD_PROF_DWT_CTRL
+#define LCD_PROF_DWT_CTRL           ( *(volatile uint32_t *)0xE0001000 )
+#endif
+
+#ifndef LCD_PROF_DWT_CYCCNT
+#define LCD_PROF_DWT_CYCCNT         ( *(volatile uint32_t *)0xE0001004 )
+#endif
+
+#define LCD_PROF_DWT_CYCCNTENA      ( 1UL << 0 )
+
+
+typedef enum
+{
+    LCD_PROF_CMD = 0,           /* lcd_cmd() */
+    LCD_PROF_DATA_LINE,         /* lcd_data_line() */
+    LCD_PROF_I2C_CMD,           /* lcd_i2c_cmd() */
+    LCD_PROF_I2C_REQUEST,       /* i2c_request() */
+    LCD_PROF_I2C_WRITE,         /* i2c_write() */
+    LCD_PROF_BUSY_WAIT,         /* lcd_busy_wait() */
+    LCD_PROF_POINTS
+} lcdProfPoint_t;
+
+
+typedef struct
+{
+    uint32_t count;             /* number of calls */
+    uint32_t min;               /* cycles, 0xFFFFFFFF until the first call */
+    uint32_t max;               /* cycles */
+    uint64_t sum;               /* cycles, mean is sum / count */
+    uint32_t hist[LCD_PROF_BUCKETS];
+} lcdProfStat_t;
+
+
+
+#if ( USE_LCD_PROFILING )
+
+extern lcdProfStat_t lcd_prof[LCD_PROF_POINTS];
+
+#define LCD_PROF_BEGIN(start)               uint32_t start = LCD_PROF_DWT_CYCCNT
+#define LCD_PROF_END(point, start)          lcd_prof_record( (point), LCD_PROF_DWT_CYCCNT - (start) )
+
+
+
+/**
+ * @brief    Enable the DWT cycle counter and clear the statistics. Call
+ *           this before lcd_init().
+ * @param    none
+ * @retval   none
+ */
+void lcd_prof_init(void);
+
+
+
+/**
+ * @brief    Clear the statistics of every probe point
+ * @param    none
+ * @retval   none
+ */
+void lcd_prof_reset(void);
+
+
+
+/**
+ * @brief    Add a measurement to a probe point, used by LCD_PROF_END
+ * @param    point: probe point
+ * @param    cycles: CYCCNT delta
+ * @retval   none
+ */
+void lcd_prof_record(lcdProfPoint_t point, uint32_t cycles);
+
+
+
+/**
+ * @brief    Mean cycles per call of a probe point
+ * @param    point: probe point
+ * @retval   mean in cycles, 0 when the point was never hit
+ */
+uint32_t lcd_prof_mean(lcdProfPoint_t point);
+
+#else
+
+#define LCD_PROF_BEGIN(start)
+#define LCD_PROF_END(point, start)
+
+#endif
+
+
+#endif /* __LCD_PROF_H */
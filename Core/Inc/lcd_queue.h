@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+  * @file    lcd_queue.h
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Lock-free multi-producer message queue for the 1602 LCD driver.
+  *
+  *          Interrupt handlers post short messages with lcd_post(), the main
+  *          loop renders them with lcd_queue_process(). Slots are reserved
+  *          with LDREX/STREX so producers of any priority never block and
+  *          never touch the I2C bus themselves.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#ifndef __LCD_QUEUE_H
+#define __LCD_QUEUE_H
+
+#include <stdint.h>
+
+
+/**
+ * ******************************************************************************
+ * Configuration Guide:
+ *
+ * LCD_QUEUE_SLOTS                  number of pending messages, power of two
+ * LCD_QUEUE_MSG_LEN                maximum characters per message
+ * ******************************************************************************
+ */
+
+
+#define LCD_QUEUE_SLOTS             8
+#define LCD_QUEUE_MSG_LEN           16
+
+
+
+/**
+ * @brief    Post a message to be printed at row, col. Safe to call from
+ *           any interrupt priority and from thread mode. Never blocks,
+ *           the message is dropped when the queue is full.
+ * @param    row: First row (1), second row (2)
+ * @param    col: any value from 1-16
+ * @param    str: null terminated string, truncated to LCD_QUEUE_MSG_LEN
+ * @retval   1 if the message was queued, 0 if the queue is full
+ */
+uint8_t lcd_post(uint8_t row, uint8_t col, const char *str);
+
+
+
+/**
+ * @brief    Render every completed message in posting order. Call this
+ *           from the main loop, it is the only place the queue touches
+ *           the LCD.
+ * @param    none
+ * @retval   none
+ */
+void lcd_queue_process(void);
+
+
+#endif /* __LCD_QUEUE_H */
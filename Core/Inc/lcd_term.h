@@ -0,0 +1,123 @@
+/**
+  ******************************************************************************
+  * @file    lcd_term.h
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   VT100/ANSI terminal on the 16x2 display.
+  *
+  *          Characters are drawn into the shadow framebuffer (lcd_fb.h),
+  *          lcd_term_flush() sends only the cells that changed, so a host
+  *          tool redrawing a whole screen with escape sequences costs the
+  *          bus nothing for the cells it left alone.
+  *
+  *          Supported, everything else is consumed and ignored:
+  *
+  *          CR, LF, BS, FF         column 1, next line (scrolls), left,
+  *                                 clear screen
+  *          ESC c                  reset
+  *          CSI row;col H / f      cursor position, 1-based
+  *          CSI n A / B / C / D    cursor up, down, right, left
+  *          CSI n J                erase 0 to end, 1 to start, 2 screen
+  *          CSI n K                erase 0 to end, 1 to start, 2 line
+  *          CSI ?25 h / l          show / hide the cursor
+  *          CSI ?12 h / l          blink / steady cursor
+  *
+  *          The cursor shows as the underline cursor, blinking as the
+  *          blinking block, see lcd_display_ctrl(). Text wraps at the end
+  *          of a row.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+#ifndef __LCD_TERM_H
+#define __LCD_TERM_H
+
+#include "lcd.h"
+#include "lcd_fb.h"
+
+
+/**
+ * ******************************************************************************
+ * Configuration Guide:
+ *
+ * LCD_TERM_MAX_PARAMS              numeric parameters kept of a CSI
+ *                                  sequence, the ones past it are ignored
+ * ******************************************************************************
+ */
+
+
+#define LCD_TERM_MAX_PARAMS         4
+
+
+
+/**
+ * @brief    Reset the terminal: clear screen, cursor home and hidden,
+ *           the next flush repaints everything
+ * @param    none
+ * @retval   none
+ */
+void lcd_term_init(void);
+
+
+
+/**
+ * @brief    Interpret a character of the input stream
+ * @param    ch: character, control code or part of an escape sequence
+ * @retval   none
+ */
+void lcd_term_putc(uint8_t ch);
+
+
+
+/**
+ * @brief    Interpret len characters of the input stream
+ * @param    buf: pointer to the characters
+ * @param    len: number of characters
+ * @retval   none
+ */
+void lcd_term_write(const uint8_t *buf, size_t len);
+
+
+
+/**
+ * @brief    Check for changes not shown on the LCD yet
+ * @param    none
+ * @retval   1 when a flush is needed, 0 otherwise
+ */
+uint8_t lcd_term_pending(void);
+
+
+
+/**
+ * @brief    Send the changed cells, the cursor mode and, when the cursor
+ *           is shown, its position to the LCD. What failed on the bus is
+ *           sent again by the next flush.
+ * @param    none
+ * @retval   number of characters sent
+ */
+uint16_t lcd_term_flush(void);
+
+
+#endif /* __LCD_TERM_H */
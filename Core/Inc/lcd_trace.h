@@ -0,0 +1,125 @@
+/**
+  ******************************************************************************
+  * @file    lcd_trace.h
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Optional ITM/SWO event trace of the LCD and I2C drivers.
+  *
+  *          Every I2C START, address, data byte and STOP and every LCD
+  *          instruction and character is sent as one 32-bit word on ITM
+  *          stimulus port LCD_TRACE_PORT, timestamped with the DWT cycle
+  *          counter:
+  *
+  *          bits 31-28   event (lcdTraceEvent_t)
+  *          bits 27-20   data: address byte, data byte or instruction
+  *          bits 19-0    CYCCNT cycles since the previous packet
+  *
+  *          A gap longer than 20 bits is preceded by a LCD_TRACE_TIME
+  *          packet holding the upper bits (gap >> 20) in bits 27-0.
+  *
+  *          The SWO pin, TPIU and ITM are set up by the debugger (e.g.
+  *          "tpiu config internal swo.bin uart off 72000000" and "itm port 1
+  *          on" in OpenOCD). Nothing is emitted while the ITM or the port is
+  *          disabled. Decode a capture with build/host/swodecode.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+#ifndef __LCD_TRACE_H
+#define __LCD_TRACE_H
+
+#include <stdint.h>
+
+
+/**
+ * ******************************************************************************
+ * Configuration Guide:
+ *
+ * Setting macro to 1 enables it, 0 otherwise
+ *
+ * USE_LCD_TRACE                    send trace packets over ITM
+ * LCD_TRACE_PORT                   ITM stimulus port, 0 is usually printf
+ * ******************************************************************************
+ */
+
+
+#define USE_LCD_TRACE               0
+#define LCD_TRACE_PORT              1
+
+
+/* Packet fields */
+#define LCD_TRACE_EVENT_POS         28
+#define LCD_TRACE_DATA_POS          20
+#define LCD_TRACE_DELTA_BITS        20
+#define LCD_TRACE_DELTA_MASK        ( (1UL << LCD_TRACE_DELTA_BITS) - 1 )
+
+
+typedef enum
+{
+    LCD_TRACE_I2C_START = 1,    /* START or repeated START */
+    LCD_TRACE_I2C_ADDR,         /* address byte sent, data = address + RnW */
+    LCD_TRACE_I2C_WRITE,        /* data byte written */
+    LCD_TRACE_I2C_READ,         /* data byte read */
+    LCD_TRACE_I2C_STOP,         /* STOP */
+    LCD_TRACE_LCD_INSTR,        /* instruction started, data = instruction */
+    LCD_TRACE_LCD_DATA,         /* character started, data = character */
+    LCD_TRACE_LCD_END,          /* instruction or character done */
+    LCD_TRACE_TIME = 0x0F       /* upper bits of the next gap */
+} lcdTraceEvent_t;
+
+
+
+#if ( USE_LCD_TRACE )
+
+#define LCD_TRACE(event, data)      lcd_trace_event( (event), (uint8_t)(data) )
+
+
+
+/**
+ * @brief    Enable the DWT cycle counter used for the timestamps. The ITM
+ *           itself is enabled by the debugger.
+ * @param    none
+ * @retval   none
+ */
+void lcd_trace_init(void);
+
+
+
+/**
+ * @brief    Send a trace packet, used by LCD_TRACE
+ * @param    event: event
+ * @param    data: event data
+ * @retval   none
+ */
+void lcd_trace_event(lcdTraceEvent_t event, uint8_t data);
+
+#else
+
+#define LCD_TRACE(event, data)
+
+#endif
+
+
+#endif /* __LCD_TRACE_H */
@@ -0,0 +1,107 @@
+/**
+  ******************************************************************************
+  * @file    lcd_view.h
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Viewport over the 40 DDRAM columns of each LCD line. The display
+  *          shows 16 of them, starting at the column selected by the
+  *          display shift.
+  *
+  *          Content is written ahead of time into the columns that are off
+  *          screen, then moved into view with display shift instructions.
+  *          A scroll step is one instruction instead of rewriting the 32
+  *          visible characters.
+  *
+  *          Both lines shift together. lcd_fb, lcd_term and lcd_cop expect
+  *          an unshifted display, call lcd_view_set(1) before handing the
+  *          display back to them.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+#ifndef __LCD_VIEW_H
+#define __LCD_VIEW_H
+
+#include "lcd.h"
+
+
+/* Columns on the display */
+#define LCD_VIEW_COLS               16
+
+
+
+/**
+ * @brief    Write len characters into DDRAM starting at row, col, in one
+ *           bus transaction. Past column 40 the write continues at column
+ *           1 of the same row.
+ * @param    row: First row (1), second row (2)
+ * @param    col: DDRAM column 1-40, on screen or not
+ * @param    buf: pointer to the characters
+ * @param    len: number of characters, at most 40
+ * @retval   none
+ */
+void lcd_view_write(uint8_t row, uint8_t col, const uint8_t *buf, size_t len);
+
+
+
+/**
+ * @brief    Move the viewport by steps columns, one display shift
+ *           instruction each. The viewport wraps around the 40 columns.
+ *           Starts from column 1 when a bus error left the shift unknown.
+ * @param    steps: > 0 to the right (text moves left), < 0 to the left
+ * @retval   none
+ */
+void lcd_view_scroll(int8_t steps);
+
+
+
+/**
+ * @brief    Show DDRAM column col at the left edge of the display, with the
+ *           fewest shift instructions, at most 20
+ * @param    col: DDRAM column 1-40
+ * @retval   none
+ */
+void lcd_view_set(uint8_t col);
+
+
+
+/**
+ * @brief    Get the DDRAM column shown at the left edge of the display
+ * @param    none
+ * @retval   column 1-40, 0 when a bus error left the shift unknown
+ */
+uint8_t lcd_view_col(void);
+
+
+
+/**
+ * @brief    Check whether a DDRAM column is on the display
+ * @param    col: DDRAM column 1-40
+ * @retval   1 if on screen, 0 if off screen or the shift is unknown
+ */
+uint8_t lcd_view_visible(uint8_t col);
+
+
+#endif /* __LCD_VIEW_H */
@@ -35,9 +35,45 @@
 
 #include "stm32f10x.h"
 #include "i2c.h"
+#include "lcd_prof.h"
+#include "lcd_trace.h"
+#include "i2c_capture.h"
 
 
 
+/* APB1 clock feeding I2C1, see CR2 in i2c_config() */
+#define I2C_PCLK1_HZ                36000000UL
+
+/* Status register reads. ADDR is cleared by reading SR1 then SR2, a host
+   build sees the reads to follow that sequence */
+#ifndef I2C_SR1_READ
+#define I2C_SR1_READ()              ( I2C1->SR1 )
+#define I2C_SR2_READ()              ( I2C1->SR2 )
+#endif
+
+/* SCL frequency programmed in CCR */
+static uint32_t i2c_speed = I2C_SCL_STANDARD_HZ;
+
+/* Set when i2c_slave_poll() already cleared ADDR of a slave transfer */
+static uint8_t slave_matched = 0;
+
+/* Bytes moved by the last slave transfer */
+static volatile uint8_t slave_count = 0;
+
+/* Interrupt slave, see i2c_slave_irq_start() */
+#define I2C_SLAVE_IRQ_BITS          ( I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_ITERREN )
+
+static const i2cSlaveHooks_t *slave_hooks = NULL;
+static volatile i2cSlaveDir_t slave_state = I2C_SLAVE_IDLE;
+static uint8_t slave_rx[I2C_SLAVE_RX_SIZE];
+static uint8_t slave_dropped = 0;
+static const uint8_t *slave_tx = NULL;
+static uint8_t slave_tx_len = 0;
+
+/* Counts every byte served by the interrupts, i2c_start() watches it */
+static volatile uint8_t slave_progress = 0;
+
+
 /* I2C enums */
 typedef enum
 {
@@ -51,6 +87,14 @@ typedef enum
 static void i2c_config(void);
 static void i2c_gpio(void);
 static void i2c_ack_bit(i2cAckBit_t ack_nack);
+static i2cStatus_t i2c_wait(uint16_t flags);
+static i2cStatus_t i2c_wait_all(uint16_t flags);
+static i2cStatus_t i2c_error(uint16_t sr1);
+static void i2c_half_bit(void);
+static void i2c_stop_condition(void);
+static void i2c_slave_hold(void);
+static void i2c_slave_arm(void);
+static void i2c_slave_end(void);
 
 
 
@@ -80,6 +124,11 @@ void i2c_init(void)
  */
 void i2c_start(void)
 {
+    /* The polled master sequence owns I2C1 until i2c_stop() */
+    i2c_slave_hold();
+
+    LCD_TRACE(LCD_TRACE_I2C_START, 0);
+    I2C_CAPTURE(I2C_CAP_START, 0);
     I2C1->CR1 |= I2C_CR1_START;
 }
 
@@ -92,7 +141,10 @@ void i2c_start(void)
  */
 void i2c_stop(void)
 {
-    I2C1->CR1 |= I2C_CR1_STOP;
+    i2c_stop_condition();
+
+    /* The bus is released, addressed transfers are served again */
+    i2c_slave_arm();
 }
 
 
@@ -122,16 +174,35 @@ static void i2c_ack_bit(i2cAckBit_t ack_bit)
  * @brief    This function is called after issuing a start condition,
  *           this initiates the communication to slave device.
  * @param    slave_addr_rw: pre-shifted slave address and pre-appended RnW bit
- * @retval   none
+ * @retval   I2C_OK, or the error that ended the transfer
  */
-void i2c_request(uint8_t slave_addr_rw)
+i2cStatus_t i2c_request(uint8_t slave_addr_rw)
 {
-    /* EV5 - SB = 1 */
-    while( !(I2C1->SR1 & I2C_SR1_SB) );         
-    I2C1->DR = slave_addr_rw;
+    LCD_PROF_BEGIN(prof_start);
 
-    /* EV6 - ADDR = 1 */
-    while( !((I2C1->SR1 & I2C_SR1_ADDR)) );     
+    /* EV5 - SB = 1. ADDR instead means another master addressed this
+       MCU at STM32F1_SLV_ADDR before the START went out: the bus is
+       lost to it and held until the slave transfer is served */
+    i2cStatus_t status = i2c_wait(I2C_SR1_SB | I2C_SR1_ADDR);
+
+    if( (status == I2C_OK) && !(I2C_SR1_READ() & I2C_SR1_SB) )
+    {
+        I2C1->CR1 &= ~( I2C_CR1_START );
+        status = I2C_ERR_ARLO;
+        i2c_slave_arm();
+    }
+    else if( status == I2C_OK )
+    {
+        I2C1->DR = slave_addr_rw;
+
+        /* EV6 - ADDR = 1 */
+        status = i2c_wait(I2C_SR1_ADDR);
+    }
+    LCD_TRACE(LCD_TRACE_I2C_ADDR, slave_addr_rw);
+    I2C_CAPTURE(I2C_CAP_ADDR, slave_addr_rw);
+
+    LCD_PROF_END(LCD_PROF_I2C_REQUEST, prof_start);
+    return status;
 }
 
 
@@ -139,18 +210,29 @@ void i2c_request(uint8_t slave_addr_rw)
 /**
  * @brief    Transmit a byte of data
  * @param    data: 1 byte data to be transmitted
- * @retval   none
+ * @retval   I2C_OK, or the error that ended the transfer
  */
-void i2c_write(uint8_t data)
+i2cStatus_t i2c_write(uint8_t data)
 {
+    LCD_PROF_BEGIN(prof_start);
+
     /* EV6 - address matched, ADDR = 1. Clear ADDR bit */
-    I2C1->SR2 = I2C1->SR2;
+    (void)I2C_SR2_READ();
     /* EV8_1 - Write data to DR */
-    while ( !(I2C1->SR1 & I2C_SR1_TXE ));
-    I2C1->DR = data;
-    /* EV8_2 - data byte transmitted */
-    while( (!(I2C1->SR1 & I2C_SR1_BTF)) && (!(I2C1->SR1 & I2C_SR1_TXE)) );
+    i2cStatus_t status = i2c_wait(I2C_SR1_TXE);
+
+    if( status == I2C_OK )
+    {
+        I2C1->DR = data;
+        /* EV8_2 - data byte transmitted */
+        status = i2c_wait(I2C_SR1_BTF | I2C_SR1_TXE);
+    }
     /* Issue a stop condition after exiting this function */
+    LCD_TRACE(LCD_TRACE_I2C_WRITE, data);
+    I2C_CAPTURE(I2C_CAP_WRITE, data);
+
+    LCD_PROF_END(LCD_PROF_I2C_WRITE, prof_start);
+    return status;
 }
 
 
@@ -158,54 +240,87 @@ void i2c_write(uint8_t data)
 /**
  * @brief    Transmit a N byte of data
  * @param    mode: MASTER or SLAVE transmitter
- * @param    data_bytes: number of bytes to transmit
+ * @param    data_bytes: number of bytes to transmit. When in SLAVE mode
+ *                       the master reads until it NACKs, 0xFF is sent
+ *                       once data_buffer is exhausted.
  * @param    data_buffer: pointer to array where data are stored
- * @retval   none
+ * @retval   I2C_OK, or the error that ended the transfer
  */
-void i2c_write_burst(i2cMode_t mode, uint8_t data_bytes, uint8_t *data_buffer)
+i2cStatus_t i2c_write_burst(i2cMode_t mode, uint8_t data_bytes, uint8_t *data_buffer)
 {
+    i2cStatus_t status = I2C_OK;
+
     if( mode )
     {
         /* EV6 - address matched, ADDR = 1. Clear ADDR bit */
-        I2C1->SR2 = I2C1->SR2;
+        (void)I2C_SR2_READ();
         /* EV8_1 - Loop through the buffer to transmit data */
-        for(uint8_t i = 0; i != data_bytes; i++)
+        for(uint8_t i = 0; (i != data_bytes) && (status == I2C_OK); i++)
         {
-            while ( !(I2C1->SR1 & I2C_SR1_TXE) );   
-            I2C1->DR = *(data_buffer + i);
+            status = i2c_wait(I2C_SR1_TXE);
+            if( status == I2C_OK )
+            {
+                I2C1->DR = *(data_buffer + i);
+                I2C_CAPTURE(I2C_CAP_WRITE, *(data_buffer + i));
+            }
         }
         /* EV8_2 - All data bytes transmitted */
-        while( (!(I2C1->SR1 & I2C_SR1_BTF)) || (!(I2C1->SR1 & I2C_SR1_TXE)) );
+        if( status == I2C_OK )
+        {
+            status = i2c_wait_all(I2C_SR1_BTF | I2C_SR1_TXE);
+        }
         /* Issue a stop condition after exiting this function */
     }
     else
     {
         /* Set ACK bit before transmission starts */
         i2c_ack_bit(ACK);
-        /* EV1 - Address matched, clear ADDR bit */
-        while( !((I2C1->SR1 & I2C_SR1_ADDR)) );
-        I2C1->SR2 = I2C1->SR2;
+        /* EV1 - Address matched, clear ADDR bit, unless
+           i2c_slave_poll() did already */
+        if( !slave_matched )
+        {
+            status = i2c_wait(I2C_SR1_ADDR);
+            if( status != I2C_OK )
+            {
+                return status;
+            }
+            (void)I2C_SR2_READ();
+        }
+        slave_matched = 0;
+        slave_count = 0;
 
         uint8_t j = 0;
+        uint32_t polls = 0;
         /* EV3-1 - Loop through the buffer to transmit
-           data until NACK is received */
-        while( !(I2C1->SR1 & I2C_SR1_AF) )
+           data until NACK is received, 0xFF once the buffer is
+           exhausted */
+        while( !(I2C_SR1_READ() & I2C_SR1_AF) )
         {
+            if( ++polls > I2C_TIMEOUT_LOOPS )
+            {
+                return I2C_ERR_TIMEOUT;
+            }
+            if( !(I2C_SR1_READ() & I2C_SR1_TXE) )
+            {
+                continue;
+            }
             if(data_bytes > 1)
             {
-                I2C1->DR = *(data_buffer + j);
+                I2C1->DR = ( j < data_bytes ) ? *(data_buffer + j) : 0xFF;
                 j++;
             }
             else
             {
                 I2C1->DR = *(data_buffer);
             }
-            /* Wait for ACK from master after each byte */
-            while ( !(I2C1->SR1 & I2C_SR1_TXE) );
+            slave_count++;
+            polls = 0;
         }
         /* EV3-2 - NACK received, AF = 1, clear AF bit */
         I2C1->SR1 &= ~( I2C_SR1_AF );
     }
+
+    return status;
 }
 
 
@@ -215,22 +330,28 @@ void i2c_write_burst(i2cMode_t mode, uint8_t data_bytes, uint8_t *data_buffer)
  *           Note: Stop condition is not required to call explicitly
  *           after each call to this function. This receiving sequence
  *           handles it already.
- * @param    none
- * @retval   1 byte of data from slave
+ * @param    data: receives 1 byte of data from slave
+ * @retval   I2C_OK, or the error that ended the transfer
  */
-uint8_t i2c_read(void)
+i2cStatus_t i2c_read(uint8_t *data)
 {
     /* This procedure is only applicable for 1 byte reception */
 
     /* Clear ACK bit before reception starts */
     i2c_ack_bit(NACK);
     /* EV6_3 - Clear ADDR bit, issue a stop condition */
-    I2C1->SR2 = I2C1->SR2;
-    i2c_stop();
+    (void)I2C_SR2_READ();
+    i2c_stop_condition();
 
     /* EV7 - Data byte received, read DR */
-    while( !(I2C1->SR1 & I2C_SR1_RXNE) );
-    return I2C1->DR;
+    i2cStatus_t status = i2c_wait(I2C_SR1_RXNE);
+
+    *data = ( status == I2C_OK ) ? I2C1->DR : 0xFF;
+    i2c_slave_arm();
+
+    LCD_TRACE(LCD_TRACE_I2C_READ, *data);
+    I2C_CAPTURE(I2C_CAP_READ, *data);
+    return status;
 }
 
 
@@ -242,12 +363,17 @@ uint8_t i2c_read(void)
  *           handles it already.
  * @param    mode: MASTER or SLAVE receiver
  * @param    data_bytes: number of bytes to receive. When in SLAVE mode
- *                       this parameter is ignored.
+ *                       this parameter is the size of data_buffer, the
+ *                       reception ends at the STOP or at a repeated
+ *                       START, see i2c_slave_count().
  * @param    data_buffer: pointer to array where data will be stored
- * @retval   none
+ * @retval   I2C_OK, I2C_ERR_PARAM when data_bytes is less than 2 in
+ *           MASTER mode, or the error that ended the transfer
  */
-void i2c_read_burst(i2cMode_t mode, uint8_t data_bytes, uint8_t *data_buffer)
+i2cStatus_t i2c_read_burst(i2cMode_t mode, uint8_t data_bytes, uint8_t *data_buffer)
 {
+    i2cStatus_t status = I2C_OK;
+
     if( mode )
     {
         if(data_bytes == 2)
@@ -259,17 +385,22 @@ void i2c_read_burst(i2cMode_t mode, uint8_t data_bytes, uint8_t *data_buffer)
             i2c_ack_bit(ACK);
 
             /* EV6 - Clear ADDR1 then clear ACK bit */
-            I2C1->SR2 = I2C1->SR2;
+            (void)I2C_SR2_READ();
             i2c_ack_bit(NACK);
             
             /* EV7_3 - Data1 in DR, Data2 in shift register, BTF is set */
-            while( !(I2C1->SR1 & I2C_SR1_BTF) );
-            i2c_stop();
+            status = i2c_wait(I2C_SR1_BTF);
+            if( status == I2C_OK )
+            {
+                i2c_stop_condition();
+
+                /* Read Data1 */
+                *(data_buffer + 0) = I2C1->DR;
+                /* Read Data2 */
+                *(data_buffer + 1) = I2C1->DR;
+            }
 
-            /* Read Data1 */
-            *(data_buffer + 0) = I2C1->DR;
-            /* Read Data2 */
-            *(data_buffer + 1) = I2C1->DR;
+            I2C1->CR1 &= ~( I2C_CR1_POS );
         }
 
         else if(data_bytes > 2)
@@ -280,13 +411,17 @@ void i2c_read_burst(i2cMode_t mode, uint8_t data_bytes, uint8_t *data_buffer)
             i2c_ack_bit(ACK);
 
             /* EV6 - Clear ADDR1 */
-            I2C1->SR2 = I2C1->SR2;
+            (void)I2C_SR2_READ();
 
             uint8_t j = 0;
             /* EV7 - Receive each byte until only 3 remains */
             for(uint8_t i = data_bytes; i != 3; i--)
             {
-                while( !(I2C1->SR1 & I2C_SR1_RXNE) );
+                status = i2c_wait(I2C_SR1_RXNE);
+                if( status != I2C_OK )
+                {
+                    return status;
+                }
                 *(data_buffer + j) = I2C1->DR;
                 j++;
             }
@@ -296,17 +431,25 @@ void i2c_read_burst(i2cMode_t mode, uint8_t data_bytes, uint8_t *data_buffer)
             /* EV7_2 - DataN-2 in DR, DataN-1 in shift register,
             BTF is set, clear the ACK bit to NACK the last byte (DataN),
             issue a stop after reading DataN-2 */
-            while( !(I2C1->SR1 & I2C_SR1_BTF) );
+            status = i2c_wait(I2C_SR1_BTF);
+            if( status != I2C_OK )
+            {
+                return status;
+            }
             i2c_ack_bit(NACK);
             
             /* Read DataN-2, this will move DataN-1 to DR, and receive
             DataN to shift register */
             *(data_buffer + j) = I2C1->DR;              
             j++;
-            i2c_stop();
+            i2c_stop_condition();
 
             /* Read DataN-1, DataN will move to DR*/
-            while( !(I2C1->SR1 & I2C_SR1_BTF) );
+            status = i2c_wait(I2C_SR1_BTF);
+            if( status != I2C_OK )
+            {
+                return status;
+            }
             *(data_buffer + j) = I2C1->DR;              
             j++;
 
@@ -319,31 +462,744 @@ void i2c_read_burst(i2cMode_t mode, uint8_t data_bytes, uint8_t *data_buffer)
         else
         {
             /* data_bytes must be >= 2 */
-            while(1);
+            status = I2C_ERR_PARAM;
+        }
+
+        /* The last bytes are read, the STOP ended the transfer */
+        if( status != I2C_ERR_PARAM )
+        {
+            i2c_slave_arm();
+        }
+
+        #if ( USE_I2C_CAPTURE )
+        for(uint8_t i = 0; (status == I2C_OK) && (i < data_bytes); i++)
+        {
+            I2C_CAPTURE(I2C_CAP_READ, *(data_buffer + i));
         }
+        #endif
     }
 
     else
     {
         /* Set ACK bit before reception starts */
         i2c_ack_bit(ACK);
-        /* EV1 - Address matched, clear ADDR bit */
-        while( !((I2C1->SR1 & I2C_SR1_ADDR)) );
-        I2C1->SR2 = I2C1->SR2;
+        /* EV1 - Address matched, clear ADDR bit, unless
+           i2c_slave_poll() did already */
+        if( !slave_matched )
+        {
+            status = i2c_wait(I2C_SR1_ADDR);
+            if( status != I2C_OK )
+            {
+                return status;
+            }
+            (void)I2C_SR2_READ();
+        }
+        slave_matched = 0;
+        slave_count = 0;
 
-        uint8_t j = 0;
-        while( !(I2C1->SR1 & I2C_SR1_STOPF) )
+        uint32_t polls = 0;
+        uint16_t sr1;
+
+        for(;;)
         {
-            /* EV2 - Receive each byte */
-            while( (I2C1->SR1 & I2C_SR1_RXNE) )
+            sr1 = I2C_SR1_READ();
+
+            /* EV2 - Receive each byte, the ones that do not fit
+               data_buffer are dropped */
+            if( sr1 & I2C_SR1_RXNE )
             {
-                *(data_buffer + j) = I2C1->DR;
-                j++;
+                uint8_t data = I2C1->DR;
+
+                if( slave_count < data_bytes )
+                {
+                    *(data_buffer + slave_count) = data;
+                    slave_count++;
+                }
+                polls = 0;
+                continue;
+            }
+
+            /* STOP, or a repeated START addressing this MCU again which
+               is left pending for i2c_slave_poll() */
+            if( sr1 & (I2C_SR1_STOPF | I2C_SR1_ADDR) )
+            {
+                break;
+            }
+
+            /* Bounded gap between two bytes */
+            if( ++polls > I2C_TIMEOUT_LOOPS )
+            {
+                return I2C_ERR_TIMEOUT;
             }
         }
+
         /* EV4 - Stop bit detected */
+        if( sr1 & I2C_SR1_STOPF )
+        {
+            I2C1->CR1 = I2C1->CR1;
+        }
+    }
+
+    return status;
+}
+
+
+
+/**
+ * @brief    Check without blocking whether a master addressed this MCU at
+ *           STM32F1_SLV_ADDR. Enables ACK so the address is acknowledged.
+ *           The master is held, SCL stretched, until the transfer is
+ *           served with i2c_read_burst() or i2c_write_burst() in SLAVE
+ *           mode.
+ * @param    none
+ * @retval   I2C_SLAVE_IDLE, I2C_SLAVE_RX when the master writes,
+ *           I2C_SLAVE_TX when it reads
+ */
+i2cSlaveDir_t i2c_slave_poll(void)
+{
+    i2c_ack_bit(ACK);
+
+    if( slave_matched )
+    {
+        return I2C_SLAVE_IDLE;
+    }
+    if( !(I2C_SR1_READ() & I2C_SR1_ADDR) )
+    {
+        return I2C_SLAVE_IDLE;
+    }
+
+    /* Reading SR2 after SR1 clears ADDR */
+    uint16_t sr2 = I2C_SR2_READ();
+
+    slave_matched = 1;
+    return ( sr2 & I2C_SR2_TRA ) ? I2C_SLAVE_TX : I2C_SLAVE_RX;
+}
+
+
+
+/**
+ * @brief    Get the number of bytes moved by the last slave transfer
+ * @param    none
+ * @retval   bytes received and kept, or bytes transmitted
+ */
+uint8_t i2c_slave_count(void)
+{
+    return slave_count;
+}
+
+
+
+/**
+ * @brief    Serve transfers addressed to STM32F1_SLV_ADDR from the I2C1
+ *           event and error interrupts instead of i2c_slave_poll(). Each
+ *           byte costs one short interrupt, SCL is stretched while it is
+ *           pending, so bursts at 400 kHz leave the main loop running.
+ *           The interrupts are masked while this MCU is master, from
+ *           i2c_start() to i2c_stop(); a START waits for a slave transfer
+ *           in progress to end first.
+ * @param    hooks: callbacks, must stay valid
+ * @retval   none
+ */
+void i2c_slave_irq_start(const i2cSlaveHooks_t *hooks)
+{
+    i2c_slave_irq_lock();
+
+    slave_hooks = hooks;
+    slave_state = I2C_SLAVE_IDLE;
+    slave_matched = 0;
+
+    NVIC_EnableIRQ(I2C1_EV_IRQn);
+    NVIC_EnableIRQ(I2C1_ER_IRQn);
+
+    i2c_slave_arm();
+}
+
+
+
+/**
+ * @brief    Stop the interrupt slave, addressed transfers are left to
+ *           i2c_slave_poll() again
+ * @param    none
+ * @retval   none
+ */
+void i2c_slave_irq_stop(void)
+{
+    i2c_slave_irq_lock();
+
+    NVIC_DisableIRQ(I2C1_EV_IRQn);
+    NVIC_DisableIRQ(I2C1_ER_IRQn);
+
+    slave_hooks = NULL;
+    slave_state = I2C_SLAVE_IDLE;
+}
+
+
+
+/**
+ * @brief    Hold back the interrupt slave while thread mode reads or
+ *           updates data shared with the hooks. A transfer in progress is
+ *           stretched meanwhile, keep the section short and do not start
+ *           a master transfer inside it.
+ * @param    none
+ * @retval   none
+ */
+void i2c_slave_irq_lock(void)
+{
+    I2C1->CR2 &= ~( I2C_SLAVE_IRQ_BITS );
+}
+
+
+
+/**
+ * @brief    End a section started with i2c_slave_irq_lock()
+ * @param    none
+ * @retval   none
+ */
+void i2c_slave_irq_unlock(void)
+{
+    i2c_slave_arm();
+}
+
+
+
+/**
+ * @brief    I2C1 event interrupt, serves the interrupt slave one event at
+ *           a time, see i2c_slave_irq_start()
+ * @param    none
+ * @retval   none
+ */
+void I2C1_EV_IRQHandler(void)
+{
+    uint16_t sr1 = I2C_SR1_READ();
+
+    /* A START of this MCU that waited for the bus, the polled master
+       sequence takes over */
+    if( sr1 & I2C_SR1_SB )
+    {
+        I2C1->CR2 &= ~( I2C_SLAVE_IRQ_BITS );
+        return;
+    }
+
+    /* EV1 - Address matched. A repeated START ends the write before it */
+    if( sr1 & I2C_SR1_ADDR )
+    {
+        i2c_slave_end();
+
+        /* Reading SR2 after SR1 clears ADDR */
+        uint16_t sr2 = I2C_SR2_READ();
+
+        slave_count = 0;
+        slave_dropped = 0;
+
+        if( sr2 & I2C_SR2_TRA )
+        {
+            slave_tx_len = 0;
+            slave_tx = slave_hooks->transmit(&slave_tx_len);
+            slave_state = I2C_SLAVE_TX;
+        }
+        else
+        {
+            slave_state = I2C_SLAVE_RX;
+        }
+        I2C1->CR2 |= I2C_CR2_ITBUFEN;
+        sr1 = I2C_SR1_READ();
+    }
+
+    if( slave_state == I2C_SLAVE_TX )
+    {
+        /* EV3 - Next byte, 0xFF once the data is exhausted */
+        if( sr1 & I2C_SR1_TXE )
+        {
+            I2C1->DR = ( slave_count < slave_tx_len ) ? *(slave_tx + slave_count) : 0xFF;
+            if( slave_count < 0xFF )
+            {
+                slave_count++;
+            }
+            slave_progress++;
+        }
+    }
+    else if( sr1 & I2C_SR1_RXNE )
+    {
+        /* EV2 - Keep the byte if it fits. Received while idle it is left
+           over from an abandoned master read */
+        uint8_t data = I2C1->DR;
+
+        if( slave_state == I2C_SLAVE_RX )
+        {
+            if( slave_count < I2C_SLAVE_RX_SIZE )
+            {
+                slave_rx[slave_count] = data;
+                slave_count++;
+            }
+            else if( slave_dropped < 0xFF )
+            {
+                slave_dropped++;
+            }
+            slave_progress++;
+        }
+    }
+
+    /* EV4 - Stop bit detected, cleared by reading SR1 then writing CR1 */
+    if( sr1 & I2C_SR1_STOPF )
+    {
         I2C1->CR1 = I2C1->CR1;
+        i2c_slave_end();
+    }
+}
+
+
+
+/**
+ * @brief    I2C1 error interrupt. The NACK that ends a read transfer is
+ *           the normal end of it, a bus error drops the transfer in
+ *           progress.
+ * @param    none
+ * @retval   none
+ */
+void I2C1_ER_IRQHandler(void)
+{
+    /* EV3-2 - AF = 1, clear the error flags */
+    I2C1->SR1 &= ~( I2C_SR1_AF | I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_OVR );
+
+    /* TXE stays set until the master's STOP, nothing more to send */
+    I2C1->CR2 &= ~( I2C_CR2_ITBUFEN );
+    slave_state = I2C_SLAVE_IDLE;
+}
+
+
+
+/**
+ * @brief    Combined transfer: write txlen bytes, read rxlen bytes, or
+ *           write then read with a repeated START, all under a single
+ *           arbitration. With both lengths 0 only the address is sent,
+ *           which probes for a device.
+ * @param    bus: I2C_BUS_1
+ * @param    addr: 7-bit slave address
+ * @param    tx: bytes to write, may be NULL when txlen is 0
+ * @param    txlen: number of bytes to write
+ * @param    rx: receives the bytes read, may be NULL when rxlen is 0
+ * @param    rxlen: number of bytes to read, 0-255
+ * @param    flags: I2C_XFER_NOSTOP to keep the bus after a write-only
+ *                  transfer, the next transfer then starts with a
+ *                  repeated START. Reads always end with a STOP.
+ * @retval   I2C_OK, I2C_ERR_PARAM, or the error that ended the transfer
+ */
+i2cStatus_t i2c_transfer(i2cBus_t bus, uint8_t addr, const uint8_t *tx, size_t txlen,
+                         uint8_t *rx, size_t rxlen, uint8_t flags)
+{
+    i2cStatus_t status = I2C_OK;
+
+    if( (bus != I2C_BUS_1) || (addr > 0x7F) || (rxlen > 0xFF) ||
+        ((tx == NULL) && txlen) || ((rx == NULL) && rxlen) )
+    {
+        return I2C_ERR_PARAM;
+    }
+
+    /* Write phase, also taken for an address-only probe */
+    if( txlen || !rxlen )
+    {
+        i2c_start();
+        status = i2c_request( (uint8_t)(addr << 1) );
+
+        for(size_t i = 0; (i < txlen) && (status == I2C_OK); i++)
+        {
+            status = i2c_write(tx[i]);
+        }
+        if( status != I2C_OK )
+        {
+            return status;
+        }
+        if( !rxlen )
+        {
+            if( !(flags & I2C_XFER_NOSTOP) )
+            {
+                i2c_stop_condition();
+            }
+
+            /* EV6 of an address-only probe, no write cleared ADDR: read
+               SR1 then SR2. STOP is set before so that no byte follows,
+               it goes out once ADDR is cleared */
+            if( !txlen )
+            {
+                (void)I2C_SR1_READ();
+                (void)I2C_SR2_READ();
+            }
+
+            if( !(flags & I2C_XFER_NOSTOP) )
+            {
+                i2c_slave_arm();
+            }
+            return I2C_OK;
+        }
+    }
+
+    /* Read phase, a repeated START after a write phase */
+    i2c_start();
+    status = i2c_request( (uint8_t)((addr << 1) | 0x01) );
+    if( status != I2C_OK )
+    {
+        return status;
+    }
+
+    if( rxlen == 1 )
+    {
+        status = i2c_read(rx);
+    }
+    else
+    {
+        status = i2c_read_burst(MASTER, (uint8_t)rxlen, rx);
+    }
+
+    return status;
+}
+
+
+
+/**
+ * @brief    Change the SCL frequency. I2C1 is disabled while CCR and
+ *           TRISE are written, call it between transfers only. Up to
+ *           100 kHz standard mode is used, above it fast mode with a
+ *           2:1 duty cycle; the divider rounds towards a lower frequency.
+ *           i2c_init() and i2c_bus_recover() go back to 100 kHz.
+ * @param    hz: I2C_SCL_MIN_HZ to I2C_SCL_FAST_HZ
+ * @retval   I2C_OK, I2C_ERR_PARAM when hz is out of range
+ */
+i2cStatus_t i2c_set_speed(uint32_t hz)
+{
+    if( (hz < I2C_SCL_MIN_HZ) || (hz > I2C_SCL_FAST_HZ) )
+    {
+        return I2C_ERR_PARAM;
+    }
+    if( hz == i2c_speed )
+    {
+        return I2C_OK;
+    }
+
+    I2C1->CR1 &= ~( I2C_CR1_PE );
+
+    if( hz <= I2C_SCL_STANDARD_HZ )
+    {
+        /* Thigh = Tlow = CCR * Tpclk1, rise time 1000ns */
+        I2C1->CCR = (uint16_t)( (I2C_PCLK1_HZ + (2 * hz) - 1) / (2 * hz) );
+        I2C1->TRISE = 0x25;
+    }
+    else
+    {
+        /* Tlow = 2 * Thigh, Thigh = CCR * Tpclk1, rise time 300ns */
+        I2C1->CCR = (uint16_t)( I2C_CCR_FS | ((I2C_PCLK1_HZ + (3 * hz) - 1) / (3 * hz)) );
+        I2C1->TRISE = 0x0B;
+    }
+
+    I2C1->CR1 |= I2C_CR1_PE;
+    i2c_speed = hz;
+
+    return I2C_OK;
+}
+
+
+
+/**
+ * @brief    Get the SCL frequency last set
+ * @param    none
+ * @retval   SCL frequency in Hz
+ */
+uint32_t i2c_get_speed(void)
+{
+    return i2c_speed;
+}
+
+
+
+/**
+ * @brief    Probe every address from first to last with an address-only
+ *           write and collect the ones that acknowledge. An absent
+ *           device costs one address byte and a STOP (about 0.1ms at
+ *           100 kHz), every probe is bounded by I2C_TIMEOUT_LOOPS.
+ * @param    first: first 7-bit address
+ * @param    last: last 7-bit address, at most 0x7F
+ * @param    found: receives the addresses that acknowledged, may be NULL
+ * @param    size: number of addresses found can hold
+ * @retval   number of addresses that acknowledged, at most size
+ */
+uint8_t i2c_scan(uint8_t first, uint8_t last, uint8_t *found, uint8_t size)
+{
+    uint8_t count = 0;
+
+    for(uint16_t addr = first; (addr <= last) && (addr <= 0x7F) && (count < size); addr++)
+    {
+        i2cStatus_t status = i2c_transfer(I2C_BUS_1, (uint8_t)addr, NULL, 0, NULL, 0, 0);
+
+        if( status == I2C_OK )
+        {
+            if( found != NULL )
+            {
+                found[count] = (uint8_t)addr;
+            }
+            count++;
+        }
+        else if( (status == I2C_ERR_TIMEOUT) || (status == I2C_ERR_BERR) )
+        {
+            /* Keep going on a clean bus, the remaining addresses may
+               still answer */
+            (void)i2c_bus_recover();
+        }
+    }
+
+    return count;
+}
+
+
+
+/**
+ * @brief    Release a bus held low by a slave that lost track of a
+ *           transfer (e.g. a reset in the middle of a read). SCL is
+ *           clocked up to 9 times as GPIO until the slave releases SDA,
+ *           followed by a STOP, then I2C1 is reset and configured again.
+ * @param    none
+ * @retval   I2C_OK, I2C_ERR_BUS_STUCK when SDA is still held low
+ */
+i2cStatus_t i2c_bus_recover(void)
+{
+    I2C1->CR1 &= ~( I2C_CR1_PE );
+
+    /* PB6 - SCL, PB7 - SDA as general purpose output Open-drain, 50 MHz,
+       both released */
+    GPIOB->BSRR = ( GPIO_BSRR_BS6 | GPIO_BSRR_BS7 );
+    GPIOB->CRL &= ~( GPIO_CRL_CNF6 | GPIO_CRL_MODE6 | GPIO_CRL_CNF7 | GPIO_CRL_MODE7 );
+    GPIOB->CRL |= ( GPIO_CRL_CNF6_0 | GPIO_CRL_MODE6 | GPIO_CRL_CNF7_0 | GPIO_CRL_MODE7 );
+    i2c_half_bit();
+
+    /* Each clock lets the slave shift out one more bit, it releases
+       SDA after the ACK slot at the latest */
+    for(uint8_t i = 0; (i < 9) && !(GPIOB->IDR & GPIO_IDR_IDR7); i++)
+    {
+        GPIOB->BSRR = GPIO_BSRR_BR6;
+        i2c_half_bit();
+        GPIOB->BSRR = GPIO_BSRR_BS6;
+        i2c_half_bit();
+    }
+
+    i2cStatus_t status = ( GPIOB->IDR & GPIO_IDR_IDR7 ) ? I2C_OK : I2C_ERR_BUS_STUCK;
+
+    /* STOP - SDA rises while SCL is high */
+    GPIOB->BSRR = GPIO_BSRR_BR6;
+    i2c_half_bit();
+    GPIOB->BSRR = GPIO_BSRR_BR7;
+    i2c_half_bit();
+    GPIOB->BSRR = GPIO_BSRR_BS6;
+    i2c_half_bit();
+    GPIOB->BSRR = GPIO_BSRR_BS7;
+    i2c_half_bit();
+
+    /* Back to I2C, the peripheral may still think the bus is busy */
+    i2c_gpio();
+    i2c_config();
+
+    return status;
+}
+
+
+
+/**
+ * @brief    Static function to wait for any of the SR1 flags, bounded by
+ *           I2C_TIMEOUT_LOOPS polls
+ * @param    flags: SR1 flags
+ * @retval   I2C_OK, or the error that ended the transfer
+ */
+static i2cStatus_t i2c_wait(uint16_t flags)
+{
+    for(uint32_t polls = 0; polls < I2C_TIMEOUT_LOOPS; polls++)
+    {
+        uint16_t sr1 = I2C_SR1_READ();
+
+        if( sr1 & (I2C_SR1_AF | I2C_SR1_ARLO | I2C_SR1_BERR) )
+        {
+            return i2c_error(sr1);
+        }
+        if( sr1 & flags )
+        {
+            return I2C_OK;
+        }
+    }
+
+    return i2c_error(0);
+}
+
+
+
+/**
+ * @brief    Static function to wait for all of the SR1 flags, bounded by
+ *           I2C_TIMEOUT_LOOPS polls
+ * @param    flags: SR1 flags
+ * @retval   I2C_OK, or the error that ended the transfer
+ */
+static i2cStatus_t i2c_wait_all(uint16_t flags)
+{
+    for(uint32_t polls = 0; polls < I2C_TIMEOUT_LOOPS; polls++)
+    {
+        uint16_t sr1 = I2C_SR1_READ();
+
+        if( sr1 & (I2C_SR1_AF | I2C_SR1_ARLO | I2C_SR1_BERR) )
+        {
+            return i2c_error(sr1);
+        }
+        if( (sr1 & flags) == flags )
+        {
+            return I2C_OK;
+        }
+    }
+
+    return i2c_error(0);
+}
+
+
+
+/**
+ * @brief    Static function to end a master transfer that failed. The
+ *           error flag is cleared and a STOP is issued, except after an
+ *           arbitration loss where the hardware already left master mode.
+ * @param    sr1: SR1 at the time of the error, 0 for a timeout
+ * @retval   error code
+ */
+static i2cStatus_t i2c_error(uint16_t sr1)
+{
+    i2cStatus_t status;
+
+    if( sr1 & I2C_SR1_AF )
+    {
+        status = I2C_ERR_NACK;
+    }
+    else if( sr1 & I2C_SR1_ARLO )
+    {
+        status = I2C_ERR_ARLO;
+    }
+    else if( sr1 & I2C_SR1_BERR )
+    {
+        status = I2C_ERR_BERR;
+    }
+    else
+    {
+        status = I2C_ERR_TIMEOUT;
+    }
+
+    I2C1->SR1 &= ~( I2C_SR1_AF | I2C_SR1_ARLO | I2C_SR1_BERR );
+
+    if( status != I2C_ERR_ARLO )
+    {
+        i2c_stop();
+    }
+    else
+    {
+        /* Now a slave, possibly addressed by the winner */
+        i2c_slave_arm();
+    }
+
+    return status;
+}
+
+
+
+/**
+ * @brief    Static function to wait half a SCL period at 100 kHz
+ * @param    none
+ * @retval   none
+ */
+static void i2c_half_bit(void)
+{
+    for(uint16_t i = 0; i < 100; i++);
+}
+
+
+
+/**
+ * @brief    Static function to request a STOP without giving I2C1 back to
+ *           the interrupt slave, the master receiver still reads DR after it
+ * @param    none
+ * @retval   none
+ */
+static void i2c_stop_condition(void)
+{
+    I2C1->CR1 |= I2C_CR1_STOP;
+    LCD_TRACE(LCD_TRACE_I2C_STOP, 0);
+    I2C_CAPTURE(I2C_CAP_STOP, 0);
+}
+
+
+
+/**
+ * @brief    Static function to mask the interrupt slave for a master
+ *           transfer. A slave transfer in progress is served to its end
+ *           first, bounded by I2C_TIMEOUT_LOOPS polls between two bytes.
+ * @param    none
+ * @retval   none
+ */
+static void i2c_slave_hold(void)
+{
+    if( slave_hooks == NULL )
+    {
+        return;
+    }
+
+    uint8_t progress = slave_progress;
+    uint32_t polls = 0;
+
+    I2C1->CR2 &= ~( I2C_SLAVE_IRQ_BITS );
+
+    while( (slave_state != I2C_SLAVE_IDLE) && (polls < I2C_TIMEOUT_LOOPS) )
+    {
+        /* Let the interrupts of the transfer in for a moment */
+        I2C1->CR2 |= I2C_SLAVE_IRQ_BITS;
+
+        if( slave_progress != progress )
+        {
+            progress = slave_progress;
+            polls = 0;
+        }
+        else
+        {
+            polls++;
+        }
+
+        I2C1->CR2 &= ~( I2C_SLAVE_IRQ_BITS );
+    }
+}
+
+
+
+/**
+ * @brief    Static function to give I2C1 back to the interrupt slave once
+ *           this MCU's STOP is on the bus, ACK is enabled for the address
+ * @param    none
+ * @retval   none
+ */
+static void i2c_slave_arm(void)
+{
+    if( slave_hooks == NULL )
+    {
+        return;
+    }
+
+    for(uint32_t polls = 0; (I2C1->CR1 & I2C_CR1_STOP) && (polls < I2C_TIMEOUT_LOOPS); polls++);
+
+    i2c_ack_bit(ACK);
+    I2C1->CR2 |= I2C_SLAVE_IRQ_BITS;
+}
+
+
+
+/**
+ * @brief    Static function to end the transfer of the interrupt slave,
+ *           a write transfer is handed to the received hook
+ * @param    none
+ * @retval   none
+ */
+static void i2c_slave_end(void)
+{
+    if( slave_state == I2C_SLAVE_RX )
+    {
+        slave_hooks->received(slave_rx, slave_count, slave_dropped);
     }
+    slave_state = I2C_SLAVE_IDLE;
 }
 
 
@@ -368,12 +1224,18 @@ static void i2c_config(void)
 
     /* Configure I2C SCL to 100 KHz */
     I2C1->CCR = 0xB4;
+    i2c_speed = I2C_SCL_STANDARD_HZ;
 
     /* Configure SCL rise time */
     I2C1->TRISE = 0x25;
 
     /* Enable I2C1 */
     I2C1->CR1 |= I2C_CR1_PE;
+
+    /* The reset cleared the interrupt enables, a slave transfer in
+       progress is lost */
+    slave_state = I2C_SLAVE_IDLE;
+    i2c_slave_arm();
 }
 
 
@@ -0,0 +1,150 @@
+/**
+  ******************************************************************************
+  * @file    i2c_arb.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Priority arbiter for devices sharing I2C1 with the LCD. See
+  *          i2c_arb.h.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include "i2c_arb.h"
+
+
+static i2cArbJob_t *arb_job[I2C_ARB_MAX_JOBS];
+static uint8_t arb_jobs = 0;
+
+/* Set by i2c_arb_request(), lets the LCD driver check with one load */
+static volatile uint8_t arb_pending = 0;
+
+/* Set while i2c_arb_service() runs, a done callback that writes to the
+   LCD must not re-enter it */
+static uint8_t arb_busy = 0;
+
+
+
+/**
+ * @brief    Register a job, jobs registered first have the higher
+ *           priority. Call from thread mode during initialization.
+ * @param    job: job, must stay valid
+ * @retval   1 if registered, 0 if I2C_ARB_MAX_JOBS are registered
+ */
+uint8_t i2c_arb_register(i2cArbJob_t *job)
+{
+    if( arb_jobs >= I2C_ARB_MAX_JOBS )
+    {
+        return 0;
+    }
+
+    job->pending = 0;
+    job->status = I2C_OK;
+    arb_job[arb_jobs++] = job;
+    return 1;
+}
+
+
+
+/**
+ * @brief    Mark a registered job pending. Safe to call from any
+ *           interrupt priority, a job already pending runs once.
+ * @param    job: registered job
+ * @retval   none
+ */
+void i2c_arb_request(i2cArbJob_t *job)
+{
+    /* Byte stores are atomic, the job flag is set before the summary
+       flag so the service loop never misses it */
+    job->pending = 1;
+    arb_pending = 1;
+}
+
+
+
+/**
+ * @brief    Check for pending jobs
+ * @param    none
+ * @retval   1 if a job is pending, 0 otherwise
+ */
+uint8_t i2c_arb_pending(void)
+{
+    return arb_pending && !arb_busy;
+}
+
+
+
+/**
+ * @brief    Run every pending job, highest priority first. Must not be
+ *           called with a transaction open on the bus.
+ * @param    none
+ * @retval   none
+ */
+void i2c_arb_service(void)
+{
+    if( arb_busy )
+    {
+        return;
+    }
+    arb_busy = 1;
+
+    while( arb_pending )
+    {
+        arb_pending = 0;
+
+        for(uint8_t i = 0; i < arb_jobs; i++)
+        {
+            i2cArbJob_t *job = arb_job[i];
+
+            if( !job->pending )
+            {
+                continue;
+            }
+            job->pending = 0;
+
+            /* The LCD may run faster, it sets its own speed again */
+            (void)i2c_set_speed(I2C_SCL_STANDARD_HZ);
+            job->status = i2c_transfer(I2C_BUS_1, job->addr, job->tx, job->txlen,
+                                       job->rx, job->rxlen, 0);
+            if( (job->status == I2C_ERR_TIMEOUT) || (job->status == I2C_ERR_BERR) )
+            {
+                (void)i2c_bus_recover();
+            }
+
+            if( job->done != NULL )
+            {
+                job->done(job);
+            }
+
+            /* A higher priority job may have become pending meanwhile */
+            if( arb_pending )
+            {
+                break;
+            }
+        }
+    }
+
+    arb_busy = 0;
+}
@@ -0,0 +1,161 @@
+/**
+  ******************************************************************************
+  * @file    i2c_capture.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Optional recorder of the I2C master transactions. See
+  *          i2c_capture.h for the record and file formats.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include "i2c_capture.h"
+
+
+#if ( USE_I2C_CAPTURE )
+
+#if ( I2C_CAPTURE_SIZE & (I2C_CAPTURE_SIZE - 1) )
+#error "I2C_CAPTURE_SIZE must be a power of two"
+#endif
+
+
+static uint8_t capture_ring[I2C_CAPTURE_SIZE];
+
+/* Bytes ever recorded since the last start, the ring holds the newest */
+static uint32_t capture_head = 0;
+
+static uint8_t capture_on = 0;
+
+
+static void i2c_capture_put32(uint8_t *buf, uint32_t value);
+
+
+
+/**
+ * @brief    Drop every record and start recording
+ * @param    none
+ * @retval   none
+ */
+void i2c_capture_start(void)
+{
+    capture_head = 0;
+    capture_on = 1;
+}
+
+
+
+/**
+ * @brief    Stop recording, the records are kept
+ * @param    none
+ * @retval   none
+ */
+void i2c_capture_stop(void)
+{
+    capture_on = 0;
+}
+
+
+
+/**
+ * @brief    Add a record while recording, used by I2C_CAPTURE
+ * @param    tag: record tag
+ * @param    data: record data
+ * @retval   none
+ */
+void i2c_capture_record(i2cCaptureTag_t tag, uint8_t data)
+{
+    if( !capture_on )
+    {
+        return;
+    }
+
+    capture_ring[capture_head & (I2C_CAPTURE_SIZE - 1)] = (uint8_t)tag;
+    capture_ring[(capture_head + 1) & (I2C_CAPTURE_SIZE - 1)] = data;
+    capture_head += 2;
+}
+
+
+
+/**
+ * @brief    Write the header and the records, oldest first, to buf
+ * @param    buf: destination
+ * @param    size: size of buf, at most I2C_CAPTURE_HEADER_LEN +
+ *                 I2C_CAPTURE_SIZE bytes are needed, newer records that
+ *                 do not fit are left out
+ * @retval   bytes written, 0 when buf cannot hold the header
+ */
+uint32_t i2c_capture_export(uint8_t *buf, uint32_t size)
+{
+    if( size < I2C_CAPTURE_HEADER_LEN )
+    {
+        return 0;
+    }
+
+    uint32_t held = ( capture_head > I2C_CAPTURE_SIZE ) ? I2C_CAPTURE_SIZE : capture_head;
+    uint32_t lost = capture_head - held;
+    uint32_t from = lost;
+
+    /* Whole records only */
+    if( held > ((size - I2C_CAPTURE_HEADER_LEN) & ~1UL) )
+    {
+        held = (size - I2C_CAPTURE_HEADER_LEN) & ~1UL;
+    }
+
+    for(uint8_t i = 0; i < 4; i++)
+    {
+        buf[i] = (uint8_t)I2C_CAPTURE_MAGIC[i];
+        buf[4 + i] = 0;
+    }
+    buf[4] = I2C_CAPTURE_VERSION;
+    i2c_capture_put32(&buf[8], held / 2);
+    i2c_capture_put32(&buf[12], lost / 2);
+
+    /* Oldest record first */
+    for(uint32_t i = 0; i < held; i++)
+    {
+        buf[I2C_CAPTURE_HEADER_LEN + i] = capture_ring[(from + i) & (I2C_CAPTURE_SIZE - 1)];
+    }
+
+    return I2C_CAPTURE_HEADER_LEN + held;
+}
+
+
+
+/**
+ * @brief    Static function to store a little-endian 32-bit value
+ * @param    buf: destination
+ * @param    value: value to store
+ * @retval   none
+ */
+static void i2c_capture_put32(uint8_t *buf, uint32_t value)
+{
+    for(uint8_t i = 0; i < 4; i++)
+    {
+        buf[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+#endif
@@ -35,20 +35,111 @@
 
 
 #include "lcd.h"
+#include "lcd_prof.h"
+#include "lcd_trace.h"
 
 
 static void lcd_gpio(void);
-static void lcd_data_line(uint8_t data);
+static uint8_t lcd_data_line(uint8_t data);
 static void lcd_print_char(char data);
-static void lcd_cmd(uint8_t cmd);
+static uint8_t lcd_cmd(uint8_t cmd);
 static void lcd_busy_wait(uint32_t delay);
+static void lcd_ac_advance(void);
+static void lcd_shift_step(uint8_t right);
+
+/* Lets a host build account the time spent in lcd_busy_wait() */
+#ifndef LCD_DELAY_HOOK
+#define LCD_DELAY_HOOK(delay)
+#endif
+
+/* Value of ac while the address counter is not known */
+#define LCD_AC_UNKNOWN              0xFF
+
+/* Value of display_ctrl while the display control state is not known */
+#define LCD_CTRL_UNKNOWN            0xFF
+
+/* State shadowed by the driver for one display */
+typedef struct
+{
+    /* DDRAM address counter of the LCD as tracked by the driver */
+    uint8_t ac;
+
+    /* Last entry mode set command, I/D (bit 1) selects auto-increment */
+    uint8_t entry_mode;
+
+    /* Last display on/off control command */
+    uint8_t display_ctrl;
+
+    /* DDRAM column shown at the left edge, see lcd_shift() */
+    uint8_t shift;
+
+    #if ( USE_LCD_I2C )
+
+    /* 7-bit address of the PCF8574 */
+    uint8_t addr;
+
+    uint8_t backlight_state;
+
+    /* Set when backlight_state has not been written to PCF8574 yet */
+    uint8_t backlight_pending;
+
+    /* Last value written to PCF8574 without the backlight bit */
+    uint8_t port_state;
+
+    /* SCL frequency of the transfers to this display, see lcd_set_speed() */
+    uint32_t scl_hz;
+
+    #endif
+} lcdDev_t;
+
+#if ( USE_LCD_I2C )
+
+/* Display 0 is at LCD_SLAVE_ADDR until lcd_discover() finds others */
+static lcdDev_t lcd_dev[LCD_MAX_DISPLAYS] =
+{
+    { LCD_AC_UNKNOWN, 0x06, LCD_CTRL_UNKNOWN, 0, LCD_SLAVE_ADDR, 0x08, 0, 0x00, I2C_SCL_STANDARD_HZ }
+};
+static uint8_t lcd_devs = 1;
+
+#else
+
+static lcdDev_t lcd_dev[1] =
+{
+    { LCD_AC_UNKNOWN, 0x06, LCD_CTRL_UNKNOWN, 0 }
+};
+
+#endif
+
+/* Display the LCD calls go to, see lcd_select() */
+static lcdDev_t *lcd = &lcd_dev[0];
 
 #if ( USE_LCD_I2C )
 
 #include "i2c.h"
+#include "i2c_arb.h"
+
+/* First address of the PCF8574 (0x20-0x27) and PCF8574A (0x38-0x3F) */
+#define LCD_PCF8574_BASE            0x20
+#define LCD_PCF8574A_BASE           0x38
+
+static uint8_t lcd_i2c_cmd(uint8_t data);
+
+/* Nesting depth of lcd_batch_begin(), a transaction is open while > 0 */
+static uint8_t batch_depth = 0;
+
+/* Set when the open transaction failed, its remaining writes are dropped */
+static uint8_t batch_failed = 0;
+
+/* PCF8574 writes since the open transaction started */
+static uint8_t batch_writes = 0;
 
-static void lcd_i2c_cmd(uint8_t data);
-static uint8_t backlight_state = 0x08;
+/* First bus error since the last lcd_bus_status() */
+static i2cStatus_t bus_status = I2C_OK;
+
+static i2cStatus_t lcd_i2c_open(void);
+static void lcd_i2c_yield(void);
+static uint8_t lcd_i2c_read_nibble(uint8_t *port);
+static void lcd_bus_error(i2cStatus_t status);
 
 #else
 
@@ -70,6 +161,9 @@ void lcd_init(void)
     /* Initialize LCD GPIO pins */
     lcd_gpio();
 
+    /* Forget the shadowed state of a previously initialized LCD */
+    lcd->display_ctrl = LCD_CTRL_UNKNOWN;
+
     #if ( USE_LCD_I2C )
 
     /* initialize the i2c peripheral */
@@ -80,8 +174,9 @@ void lcd_init(void)
     /* LCD initialization sequence */
     lcd_busy_wait(100);
 
+    /* 4.1ms after the first function set, 100us after the second */
     lcd_cmd(0x03);
-    lcd_busy_wait(20);
+    lcd_busy_wait(8200);
 
     lcd_cmd(0x03);
     lcd_busy_wait(300);
@@ -96,8 +191,9 @@ void lcd_init(void)
 
     lcd_rs_pin(0);
     lcd_rw_pin(0);
+    /* 4.1ms after the first function set, 100us after the second */
     lcd_data_line(0x03);
-    lcd_busy_wait(20);
+    lcd_busy_wait(8200);
 
     lcd_data_line(0x03);
     lcd_busy_wait(300);
@@ -119,7 +215,8 @@ void lcd_init(void)
     lcd_clear();
 
     /* entry mode set */
-    lcd_cmd(0x06);
+    lcd->entry_mode = 0x06;
+    lcd_cmd(lcd->entry_mode);
     lcd_busy_wait(1);
 
 }
@@ -129,24 +226,223 @@ void lcd_init(void)
 #if ( USE_LCD_I2C )
 
 /**
- * @brief    LCD function to turn on/off the backlight
+ * @brief    LCD function to turn on/off the backlight. The new state is
+ *           carried by the next transfer to the LCD, call lcd_flush() to
+ *           apply it when nothing else is going to be written.
  * @param    state: Off (0), On (1)
  * @retval   none
  */
 void lcd_backlight(uint8_t state)
 {
-    if(state)
+    uint8_t tmp = state ? 0x08 : 0x00;
+
+    if( tmp != lcd->backlight_state )
     {
-        backlight_state = 0x08;
-        lcd_i2c_cmd(0x00);
+        lcd->backlight_state = tmp;
+        lcd->backlight_pending = 1;
     }
-    else
+}
+
+
+
+/**
+ * @brief    LCD function to write a pending backlight change that has not
+ *           been carried by any other transfer yet
+ * @param    none
+ * @retval   none
+ */
+void lcd_flush(void)
+{
+    if( lcd->backlight_pending )
     {
-        backlight_state = 0x00;
-        lcd_i2c_cmd(0x00);
+        lcd_i2c_cmd(lcd->port_state);
     }
 }
 
+
+
+/**
+ * @brief    LCD function to get the first I2C error since the previous
+ *           call and clear it. Every LCD call is bounded and returns even
+ *           with the display unplugged; after an error the LCD may have
+ *           lost its 4-bit nibble sync, call lcd_init() once this
+ *           returns I2C_OK again.
+ * @param    none
+ * @retval   I2C_OK, or the first error
+ */
+i2cStatus_t lcd_bus_status(void)
+{
+    i2cStatus_t status = bus_status;
+
+    bus_status = I2C_OK;
+    return status;
+}
+
+
+
+/**
+ * @brief    LCD function to find every PCF8574 and PCF8574A backpack on
+ *           the bus and initialize a display for each, in address order.
+ *           Absent addresses only cost an address byte, the scan takes
+ *           about 2ms at 100 kHz. Display 0 is selected afterwards.
+ * @param    none
+ * @retval   number of displays found, at most LCD_MAX_DISPLAYS. On 0 the
+ *           display at LCD_SLAVE_ADDR is kept.
+ */
+uint8_t lcd_discover(void)
+{
+    uint8_t addr[LCD_MAX_DISPLAYS];
+    uint8_t found;
+
+    if( batch_depth )
+    {
+        return 0;
+    }
+
+    lcd_gpio();
+    i2c_init();
+
+    found = i2c_scan(LCD_PCF8574_BASE, LCD_PCF8574_BASE + 7, addr, LCD_MAX_DISPLAYS);
+    found += i2c_scan(LCD_PCF8574A_BASE, LCD_PCF8574A_BASE + 7, &addr[found], LCD_MAX_DISPLAYS - found);
+
+    if( !found )
+    {
+        return 0;
+    }
+
+    for(uint8_t i = 0; i < found; i++)
+    {
+        lcd_dev[i] = (lcdDev_t){ LCD_AC_UNKNOWN, 0x06, LCD_CTRL_UNKNOWN, 0, addr[i], 0x08, 0, 0x00, I2C_SCL_STANDARD_HZ };
+        lcd = &lcd_dev[i];
+        lcd_init();
+    }
+    lcd_devs = found;
+    lcd = &lcd_dev[0];
+
+    return found;
+}
+
+
+
+/**
+ * @brief    LCD function to direct the following LCD calls to another
+ *           display. Not allowed inside lcd_batch_begin()/lcd_batch_end().
+ * @param    index: 0 up to the count returned by lcd_discover() - 1
+ * @retval   1 on success, 0 when there is no such display
+ */
+uint8_t lcd_select(uint8_t index)
+{
+    if( (index >= lcd_devs) || batch_depth )
+    {
+        return 0;
+    }
+
+    lcd = &lcd_dev[index];
+    return 1;
+}
+
+
+
+/**
+ * @brief    LCD function to get the address of the selected display
+ * @param    none
+ * @retval   7-bit I2C address
+ */
+uint8_t lcd_address(void)
+{
+    return lcd->addr;
+}
+
+
+
+/**
+ * @brief    LCD function to set the SCL frequency used for the selected
+ *           display, see lcd_calibrate() to find the highest reliable one
+ * @param    hz: I2C_SCL_MIN_HZ to I2C_SCL_FAST_HZ
+ * @retval   1 on success, 0 when hz is out of range
+ */
+uint8_t lcd_set_speed(uint32_t hz)
+{
+    if( (hz < I2C_SCL_MIN_HZ) || (hz > I2C_SCL_FAST_HZ) )
+    {
+        return 0;
+    }
+
+    lcd->scl_hz = hz;
+    return 1;
+}
+
+
+
+/**
+ * @brief    LCD function to get the SCL frequency of the selected display
+ * @param    none
+ * @retval   SCL frequency in Hz
+ */
+uint32_t lcd_speed(void)
+{
+    return lcd->scl_hz;
+}
+
+
+
+/**
+ * @brief    LCD function to read len characters back from DDRAM starting
+ *           at row, col. D7-D4 of PCF8574 are set high so the LCD can
+ *           drive them, then each nibble is read while EN is high. Not
+ *           allowed inside lcd_batch_begin()/lcd_batch_end().
+ * @param    row: First row (1), second row (2)
+ * @param    col: 1-40, only 16 columns are on screen, see lcd_shift()
+ * @param    buf: receives the characters
+ * @param    len: number of characters to read
+ * @retval   1 on success, 0 on a bus error or inside a batch
+ */
+uint8_t lcd_read(uint8_t row, uint8_t col, uint8_t *buf, size_t len)
+{
+    if( batch_depth )
+    {
+        return 0;
+    }
+
+    /* DDRAM reads need an address set right before them */
+    lcd->ac = LCD_AC_UNKNOWN;
+    lcd_goto_xy(row, col);
+    if( lcd->ac == LCD_AC_UNKNOWN )
+    {
+        return 0;
+    }
+
+    for(size_t i = 0; i < len; i++)
+    {
+        uint8_t hi, lo;
+
+        if( !lcd_i2c_read_nibble(&hi) || !lcd_i2c_read_nibble(&lo) )
+        {
+            return 0;
+        }
+        buf[i] = (uint8_t)((hi & 0xF0) | (lo >> 4));
+        lcd_ac_advance();
+    }
+
+    /* Back to write mode */
+    lcd_i2c_cmd(0x00);
+
+    return 1;
+}
+
+#else
+
+/**
+ * @brief    LCD function to get the first I2C error since the previous
+ *           call, the bit banged bus has none
+ * @param    none
+ * @retval   I2C_OK
+ */
+i2cStatus_t lcd_bus_status(void)
+{
+    return I2C_OK;
+}
+
 #endif
 
 
@@ -158,32 +454,74 @@ void lcd_backlight(uint8_t state)
  */
 void lcd_clear(void)
 {
-    lcd_cmd(0x01);
-    lcd_busy_wait(4);
+    /* Clear display executes in 1.52ms */
+    uint8_t sent = lcd_cmd(0x01);
+    lcd_busy_wait(3040);
+
+    /* Clear display resets the address counter and the shift, sets I/D */
+    if( sent )
+    {
+        lcd->ac = 0x00;
+        lcd->shift = 0;
+        lcd->entry_mode |= 0x02;
+    }
+    else
+    {
+        lcd->ac = LCD_AC_UNKNOWN;
+        lcd->shift = LCD_SHIFT_UNKNOWN;
+    }
+}
+
+
+
+/**
+ * @brief    LCD function to set the cursor to row 1, col 1 and undo the
+ *           display shift, DDRAM is left as it is
+ * @param    none
+ * @retval   none
+ */
+void lcd_home(void)
+{
+    /* Return home executes in 1.52ms */
+    uint8_t sent = lcd_cmd(0x02);
+    lcd_busy_wait(3040);
+
+    lcd->ac = sent ? 0x00 : LCD_AC_UNKNOWN;
+    lcd->shift = sent ? 0 : LCD_SHIFT_UNKNOWN;
 }
 
 
 
 /**
- * @brief    LCD Function to move the cursor on the display
+ * @brief    LCD Function to move the cursor on the display. Nothing is sent
+ *           when the address counter is already at the requested position.
  * @param    row: First row (1), second row (2)
- * @param    col: any value from 1-16
+ * @param    col: 1-40, only 16 columns are on screen, see lcd_shift()
  * @retval   none
  */
 void lcd_goto_xy(uint8_t row, uint8_t col)
 {
-    col--;
+    if( (col < 1) || (col > LCD_DDRAM_COLS) )
+    {
+        return;
+    }
+
+    uint8_t addr = col - 1;
 
     switch(row)
     {
     case 1:
-        lcd_cmd((col |= 0x80));
         break;
     case 2:
-        lcd_cmd((col |= 0xC0));
+        addr |= 0x40;
         break;
     default:
-        break;
+        return;
+    }
+
+    if( addr != lcd->ac )
+    {
+        lcd->ac = lcd_cmd(addr | 0x80) ? addr : LCD_AC_UNKNOWN;
     }
 }
 
@@ -212,7 +550,77 @@ void lcd_display_ctrl(uint8_t display, uint8_t cursor, uint8_t blinking)
     {
         tmp |= (1U << 0);
     }
-    lcd_cmd(tmp);
+
+    if( tmp != lcd->display_ctrl )
+    {
+        lcd->display_ctrl = lcd_cmd(tmp) ? tmp : LCD_CTRL_UNKNOWN;
+    }
+}
+
+
+
+/**
+ * @brief    LCD function to set the entry mode applied after each character
+ * @param    increment: Move the cursor to the right (1) or to the left (0)
+ * @param    shift    : Shift the entire display with each character (1) or not (0),
+ *                      opposite to the cursor. lcd_shift() follows it.
+ * @retval   none
+ */
+void lcd_entry_mode(uint8_t increment, uint8_t shift)
+{
+    uint8_t tmp = 0x04;
+
+    if(increment)
+    {
+        tmp |= (1U << 1);
+    }
+    if(shift)
+    {
+        tmp |= (1U << 0);
+    }
+
+    /* Kept as it was when the command did not go through, the next
+       call sends it again */
+    if( (tmp != lcd->entry_mode) && lcd_cmd(tmp) )
+    {
+        lcd->entry_mode = tmp;
+    }
+}
+
+
+
+/**
+ * @brief    LCD function to define one of the 8 custom characters, printed
+ *           afterwards as character codes 0-7. The cursor position is lost,
+ *           call lcd_goto_xy() before printing again.
+ * @param    index: character code 0-7
+ * @param    pattern: 8 rows top to bottom, 5 pixels in bits 4-0
+ * @retval   none
+ */
+void lcd_cgram(uint8_t index, const uint8_t *pattern)
+{
+    lcd_batch_begin();
+
+    lcd_cmd(0x40 | ((index & 0x07) << 3));
+
+    /* The address counter now points into CGRAM */
+    lcd->ac = LCD_AC_UNKNOWN;
+
+    /* CGRAM writes do not shift the display in entry mode S */
+    uint8_t shift = lcd->shift;
+
+    for(uint8_t i = 0; i < 8; i++)
+    {
+        lcd_print_char( (char)(pattern[i] & 0x1F) );
+    }
+
+    /* Unknown after a bus error */
+    if( lcd->shift != LCD_SHIFT_UNKNOWN )
+    {
+        lcd->shift = shift;
+    }
+
+    lcd_batch_end();
 }
 
 
@@ -224,18 +632,44 @@ void lcd_display_ctrl(uint8_t display, uint8_t cursor, uint8_t blinking)
  */
 void lcd_shift_display(uint8_t dir)
 {
+    uint8_t sent;
+
     if(dir)
     {
-        lcd_cmd(0x1C);
+        sent = lcd_cmd(0x1C);
     }
     else
     {
-        lcd_cmd(0x18);
+        sent = lcd_cmd(0x18);
+    }
+
+    if( sent )
+    {
+        lcd_shift_step(dir);
+    }
+    else
+    {
+        lcd->shift = LCD_SHIFT_UNKNOWN;
     }
 }
 
 
 
+/**
+ * @brief    LCD function to get the display shift, moved by
+ *           lcd_shift_display() and by each character printed with the
+ *           entry mode shift on
+ * @param    none
+ * @retval   DDRAM column 0-39 shown at the left edge, LCD_SHIFT_UNKNOWN
+ *           after a bus error until lcd_home() or lcd_clear()
+ */
+uint8_t lcd_shift(void)
+{
+    return lcd->shift;
+}
+
+
+
 /**
  * @brief    LCD function to print a string of characters to LCD
  * @param    str: pointer to array of characters
@@ -243,10 +677,93 @@ void lcd_shift_display(uint8_t dir)
  */
 void lcd_print_string(char *str)
 {
-    for(uint8_t i = 0; str[i] != '\0'; i++)
+    lcd_batch_begin();
+
+    while( *str != '\0' )
+    {
+        lcd_print_char(*str++);
+    }
+
+    lcd_batch_end();
+}
+
+
+
+/**
+ * @brief    LCD function to print len characters starting at row, col.
+ *           The characters are sent straight from buf in a single bus
+ *           transaction, buf does not need to be null terminated.
+ * @param    row: First row (1), second row (2)
+ * @param    col: 1-40, only 16 columns are on screen, see lcd_shift()
+ * @param    buf: pointer to the characters
+ * @param    len: number of characters to print
+ * @retval   none, nothing is written when row or col is out of range
+ */
+void lcd_write(uint8_t row, uint8_t col, const uint8_t *buf, size_t len)
+{
+    /* lcd_goto_xy() ignores a position out of range, the characters
+       would land at the current address */
+    if( (row < 1) || (row > 2) || (col < 1) || (col > LCD_DDRAM_COLS) )
+    {
+        return;
+    }
+
+    lcd_batch_begin();
+
+    lcd_goto_xy(row, col);
+    while( len-- )
+    {
+        lcd_print_char(*buf++);
+    }
+
+    lcd_batch_end();
+}
+
+
+
+/**
+ * @brief    LCD function to start collecting the following LCD calls into
+ *           a single bus transaction, until the matching lcd_batch_end().
+ *           Calls may be nested. Does nothing when bit banging.
+ *           Pending i2c_arb jobs still get the bus after every
+ *           LCD_BUS_CHUNK writes.
+ * @param    none
+ * @retval   none
+ */
+void lcd_batch_begin(void)
+{
+    #if ( USE_LCD_I2C )
+
+    if( batch_depth++ == 0 )
+    {
+        if( i2c_arb_pending() )
+        {
+            i2c_arb_service();
+        }
+        batch_failed = ( lcd_i2c_open() != I2C_OK );
+    }
+
+    #endif
+}
+
+
+
+/**
+ * @brief    LCD function to close the bus transaction opened by the
+ *           outermost lcd_batch_begin()
+ * @param    none
+ * @retval   none
+ */
+void lcd_batch_end(void)
+{
+    #if ( USE_LCD_I2C )
+
+    if( (--batch_depth == 0) && !batch_failed )
     {
-        lcd_print_char(str[i]);
+        i2c_stop();
     }
+
+    #endif
 }
 
 
@@ -258,10 +775,12 @@ void lcd_print_string(char *str)
  */
 static void lcd_print_char(char ch)
 {
+    LCD_TRACE(LCD_TRACE_LCD_DATA, ch);
+
     #if ( USE_LCD_I2C )
 
-    lcd_data_line( (ch & 0xF0) | 0x01 );
-    lcd_data_line( (ch << 4) | 0x01 );
+    /* The low nibble is not sent after a failed high nibble */
+    uint8_t sent = lcd_data_line( (ch & 0xF0) | 0x01 ) && lcd_data_line( (ch << 4) | 0x01 );
 
     #else
 
@@ -270,7 +789,105 @@ static void lcd_print_char(char ch)
     lcd_data_line(ch >> 4);
     lcd_data_line(ch & 0x0f);
 
+    uint8_t sent = 1;
+
     #endif
+
+    if( sent )
+    {
+        lcd_ac_advance();
+
+        /* Entry mode S, the display follows the cursor: left with I/D set,
+           right without */
+        if( lcd->entry_mode & 0x01 )
+        {
+            lcd_shift_step( !(lcd->entry_mode & 0x02) );
+        }
+    }
+    else
+    {
+        lcd->ac = LCD_AC_UNKNOWN;
+
+        if( lcd->entry_mode & 0x01 )
+        {
+            lcd->shift = LCD_SHIFT_UNKNOWN;
+        }
+    }
+
+    LCD_TRACE(LCD_TRACE_LCD_END, 0);
+}
+
+
+
+/**
+ * @brief    Static function that follows the LCD auto-increment or
+ *           auto-decrement of the address counter after a DDRAM write.
+ *           Line 1 spans 0x00-0x27 and line 2 spans 0x40-0x67, the
+ *           counter wraps from the end of one line to the other.
+ * @param    none
+ * @retval   none
+ */
+static void lcd_ac_advance(void)
+{
+    if( lcd->ac == LCD_AC_UNKNOWN )
+    {
+        return;
+    }
+
+    if( lcd->entry_mode & 0x02 )
+    {
+        lcd->ac++;
+
+        if( lcd->ac == 0x28 )
+        {
+            lcd->ac = 0x40;
+        }
+        else if( lcd->ac == 0x68 )
+        {
+            lcd->ac = 0x00;
+        }
+    }
+    else
+    {
+        if( lcd->ac == 0x00 )
+        {
+            lcd->ac = 0x67;
+        }
+        else if( lcd->ac == 0x40 )
+        {
+            lcd->ac = 0x27;
+        }
+        else
+        {
+            lcd->ac--;
+        }
+    }
+}
+
+
+
+/**
+ * @brief    Static function that follows a shift of the entire display by
+ *           one column. Shifting right brings the column before the left
+ *           edge into view.
+ * @param    right: 1 when the display moved right, 0 left
+ * @retval   none
+ */
+static void lcd_shift_step(uint8_t right)
+{
+    if( lcd->shift == LCD_SHIFT_UNKNOWN )
+    {
+        return;
+    }
+
+    if(right)
+    {
+        lcd->shift = (lcd->shift == 0) ? (LCD_DDRAM_COLS - 1) : (lcd->shift - 1);
+    }
+    else
+    {
+        lcd->shift = (lcd->shift == (LCD_DDRAM_COLS - 1)) ? 0 : (lcd->shift + 1);
+    }
 }
 
 
@@ -330,23 +947,34 @@ static void lcd_gpio(void)
 /**
  * @brief    Function to issue a command to LCD
  * @param    cmd: 8 bit data command. See the datasheet for more information.
- * @retval   none
+ * @retval   1 when the command went out, 0 on a bus error or inside a
+ *           failed batch
  */
-static void lcd_cmd(uint8_t cmd)
+static uint8_t lcd_cmd(uint8_t cmd)
 {
+    LCD_PROF_BEGIN(prof_start);
+    LCD_TRACE(LCD_TRACE_LCD_INSTR, cmd);
+
     #if ( USE_LCD_I2C )
 
-    lcd_data_line(cmd & 0xF0);
-    lcd_data_line( (cmd << 4));
+    /* The low nibble is not sent after a failed high nibble */
+    uint8_t sent = lcd_data_line(cmd & 0xF0) && lcd_data_line( (cmd << 4));
 
     #else
 
+    uint8_t sent = 1;
+
     lcd_rs_pin(0);
     lcd_rw_pin(0);
     lcd_data_line(cmd >> 4);
     lcd_data_line(cmd & 0x0f);
 
     #endif
+
+    LCD_TRACE(LCD_TRACE_LCD_END, 0);
+    LCD_PROF_END(LCD_PROF_CMD, prof_start);
+
+    return sent;
 }
 
 
@@ -358,15 +986,30 @@ static void lcd_cmd(uint8_t cmd)
  *           of EN pin by shifting values to bit 3 (bit position of EN
  *           pin)
  * @param    data: 8-bit data where the first nibble will be extracted
- * @retval   none
+ * @retval   1 when the nibble went out, 0 on a bus error or inside a
+ *           failed batch
  */
-static void lcd_data_line(uint8_t data)
+static uint8_t lcd_data_line(uint8_t data)
 {
+    LCD_PROF_BEGIN(prof_start);
+
     #if ( USE_LCD_I2C )
 
-    lcd_i2c_cmd(data | (1 << 2));
-    lcd_i2c_cmd(data | (0 << 2));
-    lcd_busy_wait(300);
+    /* EN stays as it is after a failed write, resynchronizing the 4-bit
+       interface is left to lcd_init() */
+    if( !lcd_i2c_cmd(data | (1 << 2)) || !lcd_i2c_cmd(data | (0 << 2)) )
+    {
+        LCD_PROF_END(LCD_PROF_DATA_LINE, prof_start);
+        return 0;
+    }
+
+    /* Inside a transaction the next EN falling edge is at least two
+       PCF8574 writes (18 SCL clocks) away, which already covers the
+       execution time of the instruction */
+    if( !batch_depth )
+    {
+        lcd_busy_wait(300);
+    }
 
     #else
 
@@ -386,6 +1029,9 @@ static void lcd_data_line(uint8_t data)
     lcd_en_pin();
 
     #endif
+
+    LCD_PROF_END(LCD_PROF_DATA_LINE, prof_start);
+    return 1;
 }
 
 
@@ -395,14 +1041,148 @@ static void lcd_data_line(uint8_t data)
 /**
  * @brief    Function that directly communicate to PCF8574
  * @param    data: 8-bit data to be transmitted via I2C line
- * @retval   none
+ * @retval   1 when written, 0 on a bus error or inside a failed batch
+ */
+static uint8_t lcd_i2c_cmd(uint8_t data)
+{
+    LCD_PROF_BEGIN(prof_start);
+
+    i2cStatus_t status;
+    uint8_t written = 0;
+
+    if( batch_depth )
+    {
+        if( !batch_failed )
+        {
+            status = i2c_write(data | lcd->backlight_state);
+            written = ( status == I2C_OK );
+            if( status != I2C_OK )
+            {
+                batch_failed = 1;
+                lcd_bus_error(status);
+            }
+            else if( batch_writes < LCD_BUS_CHUNK )
+            {
+                batch_writes++;
+            }
+            else if( !(data & (1 << 2)) && i2c_arb_pending() )
+            {
+                /* Only after an EN falling edge, the nibble is latched */
+                lcd_i2c_yield();
+            }
+        }
+    }
+    else
+    {
+        uint8_t port = data | lcd->backlight_state;
+
+        if( i2c_arb_pending() )
+        {
+            i2c_arb_service();
+        }
+
+        (void)i2c_set_speed(lcd->scl_hz);
+        status = i2c_transfer(I2C_BUS_1, lcd->addr, &port, 1, NULL, 0, 0);
+        written = ( status == I2C_OK );
+        if( status != I2C_OK )
+        {
+            lcd_bus_error(status);
+        }
+    }
+
+    lcd->port_state = data;
+    lcd->backlight_pending = 0;
+
+    LCD_PROF_END(LCD_PROF_I2C_CMD, prof_start);
+    return written;
+}
+
+
+
+/**
+ * @brief    Static function to start a write transaction to PCF8574
+ * @param    none
+ * @retval   I2C_OK, or the error that ended the transaction
  */
-static void lcd_i2c_cmd(uint8_t data)
+static i2cStatus_t lcd_i2c_open(void)
 {
+    batch_writes = 0;
+    (void)i2c_set_speed(lcd->scl_hz);
     i2c_start();
-    i2c_request(LCD_SLAVE_W_ADDR);
-    i2c_write(data | backlight_state);
+
+    i2cStatus_t status = i2c_request( (uint8_t)(lcd->addr << 1) );
+
+    if( status != I2C_OK )
+    {
+        lcd_bus_error(status);
+    }
+    return status;
+}
+
+
+
+/**
+ * @brief    Static function to let the pending i2c_arb jobs use the bus in
+ *           the middle of a transaction. PCF8574 holds its outputs, so
+ *           the LCD only sees a longer pause between two writes.
+ * @param    none
+ * @retval   none
+ */
+static void lcd_i2c_yield(void)
+{
     i2c_stop();
+    i2c_arb_service();
+    batch_failed = ( lcd_i2c_open() != I2C_OK );
+}
+
+
+
+/**
+ * @brief    Static function to read one nibble of a data read, RS and RW
+ *           high. The LCD drives D7-D4 from the EN rising edge on.
+ * @param    port: receives P7-P0, the nibble is in the upper half
+ * @retval   1 on success, 0 on a bus error
+ */
+static uint8_t lcd_i2c_read_nibble(uint8_t *port)
+{
+    lcd_i2c_cmd(0xF0 | (1 << 2) | (1 << 1) | (1 << 0));
+
+    i2cStatus_t status = i2c_transfer(I2C_BUS_1, lcd->addr, NULL, 0, port, 1, 0);
+
+    lcd_i2c_cmd(0xF0 | (0 << 2) | (1 << 1) | (1 << 0));
+
+    if( status != I2C_OK )
+    {
+        lcd_bus_error(status);
+        return 0;
+    }
+    return 1;
+}
+
+
+
+/**
+ * @brief    Static function to handle a failed transaction. What the LCD
+ *           got is unknown, so the shadowed state is dropped, and a bus
+ *           left in a bad state is recovered.
+ * @param    status: error
+ * @retval   none
+ */
+static void lcd_bus_error(i2cStatus_t status)
+{
+    if( bus_status == I2C_OK )
+    {
+        bus_status = status;
+    }
+
+    lcd->ac = LCD_AC_UNKNOWN;
+    lcd->display_ctrl = LCD_CTRL_UNKNOWN;
+    lcd->shift = LCD_SHIFT_UNKNOWN;
+
+    if( (status == I2C_ERR_TIMEOUT) || (status == I2C_ERR_BERR) )
+    {
+        (void)i2c_bus_recover();
+    }
 }
 
 #else
@@ -471,6 +1251,22 @@ static void lcd_en_pin(void)
  */
 static void lcd_busy_wait(uint32_t delay)
 {
+    LCD_PROF_BEGIN(prof_start);
+    LCD_DELAY_HOOK(delay);
+
+    #if ( USE_LCD_I2C )
+
+    /* The bus is idle while the LCD executes, the jobs only make the
+       wait longer */
+    if( !batch_depth && i2c_arb_pending() )
+    {
+        i2c_arb_service();
+    }
+
+    #endif
+
     delay = delay * 40ul;
     for(uint32_t i = 0; i < delay; i++);
+
+    LCD_PROF_END(LCD_PROF_BUSY_WAIT, prof_start);
 }
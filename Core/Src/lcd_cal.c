@@ -0,0 +1,344 @@
+/**
+  ******************************************************************************
+  * @file    lcd_cal.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   SCL calibration of the I2C displays. See lcd_cal.h.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include "lcd_cal.h"
+
+
+#if ( USE_LCD_I2C )
+
+/* Records in the page, an erased record reads 0xFFFF */
+#define LCD_CAL_RECORDS             ( LCD_CAL_PAGE_SIZE / 2 )
+#define LCD_CAL_ERASED              0xFFFF
+
+/* Other addresses kept when a full page is erased */
+#define LCD_CAL_KEEP                16
+
+/* Test patterns go to DDRAM 0x18-0x27, past the 16 visible columns */
+#define LCD_CAL_COL                 25
+#define LCD_CAL_LEN                 16
+
+/* FPEC unlock sequence */
+#define LCD_CAL_FLASH_KEY1          0x45670123UL
+#define LCD_CAL_FLASH_KEY2          0xCDEF89ABUL
+
+/* Status flags of a finished erase or program */
+#define LCD_CAL_FLASH_ERRORS        ( FLASH_SR_PGERR | FLASH_SR_WRPRTERR )
+#define LCD_CAL_FLASH_FLAGS         ( LCD_CAL_FLASH_ERRORS | FLASH_SR_EOP )
+
+/* The SR flags are cleared by writing 1 to them */
+#ifndef LCD_CAL_FLASH_SR_CLEAR
+#define LCD_CAL_FLASH_SR_CLEAR(flags)   ( FLASH->SR = (flags) )
+#endif
+
+
+static const uint32_t cal_speed[] = { 100000, 200000, 300000, 400000 };
+
+
+static uint8_t lcd_cal_verify(uint8_t pass);
+static uint8_t lcd_cal_find(uint8_t addr);
+static uint8_t lcd_cal_store(uint8_t addr, uint8_t rate);
+static uint8_t lcd_cal_erase(void);
+static uint8_t lcd_cal_program(volatile uint16_t *dst, uint16_t value);
+
+
+
+/**
+ * @brief    Find the highest SCL frequency the selected display accepts
+ *           reliably, use it for the display and store it in flash. The
+ *           display is initialized again, and so cleared, after a failed
+ *           step. The cursor is left at row 1, col 1.
+ * @param    none
+ * @retval   SCL frequency in Hz, 0 when even 100 kHz fails (nothing is
+ *           stored then). The rate is used even when the flash could
+ *           not be programmed.
+ */
+uint32_t lcd_calibrate(void)
+{
+    uint32_t best = 0;
+    uint8_t failed = 0;
+
+    for(uint8_t i = 0; i < ( sizeof(cal_speed) / sizeof(cal_speed[0]) ); i++)
+    {
+        (void)lcd_set_speed(cal_speed[i]);
+        (void)lcd_bus_status();
+
+        if( !lcd_cal_verify(0) || !lcd_cal_verify(1) )
+        {
+            failed = 1;
+            break;
+        }
+        best = cal_speed[i];
+    }
+
+    (void)lcd_set_speed( best ? best : I2C_SCL_STANDARD_HZ );
+
+    /* A corrupted transfer may have left the LCD out of nibble sync */
+    if( failed )
+    {
+        lcd_init();
+    }
+    lcd_goto_xy(1, 1);
+
+    if( best )
+    {
+        (void)lcd_cal_store(lcd_address(), (uint8_t)(best / 10000));
+    }
+
+    return best;
+}
+
+
+
+/**
+ * @brief    Apply the stored SCL frequency of the selected display
+ * @param    none
+ * @retval   1 when a rate was stored for its address, 0 otherwise
+ */
+uint8_t lcd_cal_load(void)
+{
+    uint8_t rate = lcd_cal_find(lcd_address());
+
+    if( !rate )
+    {
+        return 0;
+    }
+
+    return lcd_set_speed( (uint32_t)rate * 10000 );
+}
+
+
+
+/**
+ * @brief    Static function to write a test pattern to the off-screen
+ *           DDRAM and read it back
+ * @param    pass: 0 - alternating 0x55/0xAA, 1 - every nibble value on
+ *                 both halves
+ * @retval   1 when the pattern reads back unchanged, 0 otherwise
+ */
+static uint8_t lcd_cal_verify(uint8_t pass)
+{
+    uint8_t tx[LCD_CAL_LEN];
+    uint8_t rx[LCD_CAL_LEN];
+
+    for(uint8_t i = 0; i < LCD_CAL_LEN; i++)
+    {
+        if( pass == 0 )
+        {
+            tx[i] = ( i & 1 ) ? 0xAA : 0x55;
+        }
+        else
+        {
+            tx[i] = (uint8_t)((i << 4) | (15 - i));
+        }
+    }
+
+    lcd_write(1, LCD_CAL_COL, tx, LCD_CAL_LEN);
+    if( (lcd_bus_status() != I2C_OK) || !lcd_read(1, LCD_CAL_COL, rx, LCD_CAL_LEN) )
+    {
+        return 0;
+    }
+
+    for(uint8_t i = 0; i < LCD_CAL_LEN; i++)
+    {
+        if( rx[i] != tx[i] )
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+
+/**
+ * @brief    Static function to look up the latest rate of an address
+ * @param    addr: 7-bit address
+ * @retval   rate in 10 kHz units, 0 when none is stored
+ */
+static uint8_t lcd_cal_find(uint8_t addr)
+{
+    const volatile uint16_t *page = (const volatile uint16_t *)LCD_CAL_PAGE_ADDR;
+    uint8_t rate = 0;
+
+    for(uint16_t i = 0; (i < LCD_CAL_RECORDS) && (page[i] != LCD_CAL_ERASED); i++)
+    {
+        if( (page[i] >> 8) == addr )
+        {
+            rate = (uint8_t)page[i];
+        }
+    }
+    return rate;
+}
+
+
+
+/**
+ * @brief    Static function to append a record. A full page is erased
+ *           first and the latest rate of up to LCD_CAL_KEEP other
+ *           addresses written back.
+ * @param    addr: 7-bit address
+ * @param    rate: rate in 10 kHz units
+ * @retval   1 when stored, 0 when the erase or programming failed
+ */
+static uint8_t lcd_cal_store(uint8_t addr, uint8_t rate)
+{
+    volatile uint16_t *page = (volatile uint16_t *)LCD_CAL_PAGE_ADDR;
+    uint16_t next = 0;
+    uint8_t ok = 1;
+
+    /* Spare the flash when nothing changed */
+    if( lcd_cal_find(addr) == rate )
+    {
+        return 1;
+    }
+
+    while( (next < LCD_CAL_RECORDS) && (page[next] != LCD_CAL_ERASED) )
+    {
+        next++;
+    }
+
+    if( FLASH->CR & FLASH_CR_LOCK )
+    {
+        FLASH->KEYR = LCD_CAL_FLASH_KEY1;
+        FLASH->KEYR = LCD_CAL_FLASH_KEY2;
+    }
+
+    if( next == LCD_CAL_RECORDS )
+    {
+        uint16_t keep[LCD_CAL_KEEP];
+        uint8_t kept = 0;
+
+        /* Newest first, so the first record seen of an address is its
+           latest */
+        for(uint16_t i = LCD_CAL_RECORDS; (i > 0) && (kept < LCD_CAL_KEEP); i--)
+        {
+            uint16_t record = page[i - 1];
+            uint8_t seen = ( (record >> 8) == addr );
+
+            for(uint8_t k = 0; (k < kept) && !seen; k++)
+            {
+                seen = ( (keep[k] >> 8) == (record >> 8) );
+            }
+            if( !seen )
+            {
+                keep[kept++] = record;
+            }
+        }
+
+        ok = lcd_cal_erase();
+        for(next = 0; ok && (next < kept); next++)
+        {
+            ok = lcd_cal_program(&page[next], keep[next]);
+        }
+    }
+
+    if( ok )
+    {
+        ok = lcd_cal_program(&page[next], (uint16_t)((addr << 8) | rate));
+    }
+
+    FLASH->CR |= FLASH_CR_LOCK;
+
+    return ok;
+}
+
+
+
+/**
+ * @brief    Static function to erase the calibration page
+ * @param    none
+ * @retval   1 when every half-word reads back erased, 0 on PGERR,
+ *           WRPRTERR or a half-word left programmed
+ */
+static uint8_t lcd_cal_erase(void)
+{
+    const volatile uint16_t *page = (const volatile uint16_t *)LCD_CAL_PAGE_ADDR;
+    uint16_t sr;
+
+    while( FLASH->SR & FLASH_SR_BSY );
+    LCD_CAL_FLASH_SR_CLEAR(LCD_CAL_FLASH_FLAGS);
+
+    FLASH->CR |= FLASH_CR_PER;
+    FLASH->AR = (uint32_t)LCD_CAL_PAGE_ADDR;
+    FLASH->CR |= FLASH_CR_STRT;
+
+    while( (sr = FLASH->SR) & FLASH_SR_BSY );
+    FLASH->CR &= ~( FLASH_CR_PER );
+    LCD_CAL_FLASH_SR_CLEAR(LCD_CAL_FLASH_FLAGS);
+
+    if( sr & LCD_CAL_FLASH_ERRORS )
+    {
+        return 0;
+    }
+
+    for(uint16_t i = 0; i < LCD_CAL_RECORDS; i++)
+    {
+        if( page[i] != LCD_CAL_ERASED )
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+
+/**
+ * @brief    Static function to program a half-word of the page
+ * @param    dst: erased half-word in the page
+ * @param    value: value to program
+ * @retval   1 when the half-word reads back as value, 0 on PGERR,
+ *           WRPRTERR or a mismatch
+ */
+static uint8_t lcd_cal_program(volatile uint16_t *dst, uint16_t value)
+{
+    uint16_t sr;
+
+    while( FLASH->SR & FLASH_SR_BSY );
+    LCD_CAL_FLASH_SR_CLEAR(LCD_CAL_FLASH_FLAGS);
+
+    FLASH->CR |= FLASH_CR_PG;
+    *dst = value;
+
+    while( (sr = FLASH->SR) & FLASH_SR_BSY );
+    FLASH->CR &= ~( FLASH_CR_PG );
+    LCD_CAL_FLASH_SR_CLEAR(LCD_CAL_FLASH_FLAGS);
+
+    if( sr & LCD_CAL_FLASH_ERRORS )
+    {
+        return 0;
+    }
+    return ( *dst == value );
+}
+
+#endif
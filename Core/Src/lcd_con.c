@@ -0,0 +1,206 @@
+/**
+  ******************************************************************************
+  * @file    lcd_con.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Text console from USART1 to the LCD. See lcd_con.h.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include "lcd_con.h"
+
+
+/* APB2 clock feeding USART1 */
+#define LCD_CON_PCLK2_HZ            72000000UL
+
+/* Address as programmed in the DMA channel, the host build maps it */
+#ifndef LCD_CON_DMA_ADDR
+#define LCD_CON_DMA_ADDR(p)         ( (uint32_t)(uintptr_t)(p) )
+#endif
+
+
+/* Interpreter of the input stream */
+#if ( USE_LCD_CON_FRAMES )
+
+#define LCD_CON_RESET()             lcd_frame_init()
+#define LCD_CON_PUTC(ch)            lcd_frame_putc(ch)
+#define LCD_CON_FLUSH()             lcd_frame_flush()
+#define LCD_CON_PENDING()           lcd_frame_pending()
+
+#else
+
+#define LCD_CON_RESET()             lcd_term_init()
+#define LCD_CON_PUTC(ch)            lcd_term_putc(ch)
+#define LCD_CON_FLUSH()             lcd_term_flush()
+#define LCD_CON_PENDING()           lcd_term_pending()
+
+#endif
+
+
+/* Written by DMA1 channel 5 */
+static volatile uint8_t con_rx[LCD_CON_RX_SIZE];
+
+/* Next character to draw */
+static uint16_t con_tail = 0;
+
+/* Set by the IDLE interrupt at the end of a message */
+static volatile uint8_t con_idle = 0;
+
+/* Characters drawn since the last flush */
+static uint16_t con_unflushed = 0;
+
+/* Set until a flush went through */
+static uint8_t con_flush = 0;
+
+
+static void lcd_con_uart(void);
+
+
+
+/**
+ * @brief    Clear the console and start receiving, USART1 8N1 at
+ *           LCD_CON_BAUD
+ * @param    none
+ * @retval   none
+ */
+void lcd_con_init(void)
+{
+    LCD_CON_RESET();
+    con_tail = 0;
+    con_unflushed = 0;
+    con_idle = 0;
+    con_flush = 1;
+
+    lcd_con_uart();
+}
+
+
+
+/**
+ * @brief    Draw the characters received since the last call and flush
+ *           the framebuffer at the end of a message. Call it from the
+ *           main loop.
+ * @param    none
+ * @retval   number of characters drawn
+ */
+uint16_t lcd_con_process(void)
+{
+    /* Taken before the DMA position, a message ending meanwhile is
+       flushed by the next call */
+    if( con_idle )
+    {
+        con_idle = 0;
+        con_flush = 1;
+    }
+
+    /* CNDTR counts down from LCD_CON_RX_SIZE and reloads at 0 */
+    uint16_t head = (uint16_t)( LCD_CON_RX_SIZE - DMA1_Channel5->CNDTR );
+    uint16_t count = 0;
+
+    if( head >= LCD_CON_RX_SIZE )
+    {
+        head = 0;
+    }
+
+    while( con_tail != head )
+    {
+        LCD_CON_PUTC(con_rx[con_tail]);
+        con_tail = ( con_tail + 1 ) % LCD_CON_RX_SIZE;
+        count++;
+    }
+
+    con_unflushed += count;
+    if( con_unflushed >= LCD_CON_FLUSH_CHARS )
+    {
+        con_flush = 1;
+    }
+
+    if( con_flush )
+    {
+        /* A failed flush is retried by the next call */
+        (void)LCD_CON_FLUSH();
+        con_unflushed = 0;
+        con_flush = LCD_CON_PENDING();
+    }
+
+    return count;
+}
+
+
+
+/**
+ * @brief    USART1 interrupt, only IDLE is enabled: the line stayed quiet
+ *           for one character, the message before it is complete
+ * @param    none
+ * @retval   none
+ */
+void USART1_IRQHandler(void)
+{
+    if( USART1->SR & USART_SR_IDLE )
+    {
+        /* IDLE is cleared by reading SR then DR, DMA already took the
+           characters */
+        (void)USART1->DR;
+        con_idle = 1;
+    }
+}
+
+
+
+/**
+ * @brief    Static function to configure USART1 receive through DMA1
+ *           channel 5 into con_rx, circular, and the IDLE interrupt
+ * @param    none
+ * @retval   none
+ */
+static void lcd_con_uart(void)
+{
+    RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+    RCC->APB2ENR |= ( RCC_APB2ENR_USART1EN | RCC_APB2ENR_IOPAEN | RCC_APB2ENR_AFIOEN );
+
+    /* PA9 - TX alternate function output Push-pull, 50 MHz */
+    /* PA10 - RX input floating */
+    GPIOA->CRH &= ~( GPIO_CRH_CNF9 | GPIO_CRH_MODE9 | GPIO_CRH_CNF10 | GPIO_CRH_MODE10 );
+    GPIOA->CRH |= ( GPIO_CRH_CNF9_1 | GPIO_CRH_MODE9_1 | GPIO_CRH_MODE9_0 );
+    GPIOA->CRH |= GPIO_CRH_CNF10_0;
+
+    /* DMA1 channel 5 is USART1_RX: DR to memory, 8-bit, memory
+       increment, circular */
+    DMA1_Channel5->CCR = 0;
+    DMA1_Channel5->CPAR = LCD_CON_DMA_ADDR( &USART1->DR );
+    DMA1_Channel5->CMAR = LCD_CON_DMA_ADDR( con_rx );
+    DMA1_Channel5->CNDTR = LCD_CON_RX_SIZE;
+    DMA1_Channel5->CCR = ( DMA_CCR5_MINC | DMA_CCR5_CIRC | DMA_CCR5_EN );
+
+    /* 8N1, receiver only, RXNE served by DMA */
+    USART1->CR1 = 0;
+    USART1->BRR = (uint16_t)( (LCD_CON_PCLK2_HZ + (LCD_CON_BAUD / 2)) / LCD_CON_BAUD );
+    USART1->CR3 = USART_CR3_DMAR;
+    USART1->CR1 = ( USART_CR1_UE | USART_CR1_RE | USART_CR1_IDLEIE );
+
+    NVIC_EnableIRQ(USART1_IRQn);
+}
@@ -0,0 +1,405 @@
+/**
+  ******************************************************************************
+  * @file    lcd_cop.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Display co-processor. See lcd_cop.h for the register map.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include "lcd_cop.h"
+
+
+/* Framebuffer registers */
+#define LCD_COP_FB_SIZE             ( LCD_FB_ROWS * LCD_FB_COLS )
+
+/* Parts of the map written since the last lcd_cop_process() */
+#define LCD_COP_PEND_FB             ( 1U << 0 )
+#define LCD_COP_PEND_CTRL           ( 1U << 1 )
+#define LCD_COP_PEND_CURSOR         ( 1U << 2 )
+#define LCD_COP_PEND_INIT           ( 1U << 3 )
+
+
+static uint8_t cop_map[LCD_COP_MAP_SIZE];
+
+/* Register address of the last write */
+static uint8_t cop_reg = 0;
+
+/* Written by lcd_cop_receive(), from the I2C1 interrupt with
+   USE_LCD_COP_IRQ, lcd_cop_process() takes them under lcd_cop_lock() */
+static volatile uint8_t cop_pending = 0;
+
+/* Glyphs to upload, bit n for character code n */
+static volatile uint8_t cop_glyphs = 0;
+
+
+static void lcd_cop_store(uint8_t reg, uint8_t value);
+static const uint8_t *lcd_cop_transmit(uint8_t *len);
+static void lcd_cop_lock(void);
+static void lcd_cop_unlock(void);
+
+#if ( USE_LCD_COP_IRQ )
+
+static void lcd_cop_received(const uint8_t *buf, uint8_t len, uint8_t dropped);
+
+static const i2cSlaveHooks_t cop_hooks =
+{
+    .received = lcd_cop_received,
+    .transmit = lcd_cop_transmit
+};
+
+#endif
+
+
+
+/**
+ * @brief    Reset the register map, the framebuffer is cleared, the display
+ *           and backlight are on
+ * @param    none
+ * @retval   none
+ */
+void lcd_cop_init(void)
+{
+    lcd_cop_lock();
+
+    for(uint8_t i = 0; i < LCD_COP_MAP_SIZE; i++)
+    {
+        cop_map[i] = 0;
+    }
+    for(uint8_t i = 0; i < LCD_COP_FB_SIZE; i++)
+    {
+        cop_map[LCD_COP_FB + i] = ' ';
+    }
+    cop_map[LCD_COP_CTRL] = LCD_COP_CTRL_DISPLAY | LCD_COP_CTRL_BACKLIGHT;
+    cop_map[LCD_COP_STATUS] = LCD_COP_ST_BUSY;
+
+    cop_reg = 0;
+    cop_glyphs = 0;
+    cop_pending = LCD_COP_PEND_FB | LCD_COP_PEND_CTRL | LCD_COP_PEND_CURSOR;
+
+    lcd_fb_init();
+
+    #if ( USE_LCD_COP_IRQ )
+    i2c_slave_irq_start(&cop_hooks);
+    #else
+    lcd_cop_unlock();
+    #endif
+}
+
+
+
+/**
+ * @brief    Serve a pending transfer from the host master, if any. Polled
+ *           transport, call it often from the main loop.
+ * @param    none
+ * @retval   none
+ */
+void lcd_cop_poll(void)
+{
+    static uint8_t rx[LCD_COP_MAP_SIZE + 1];
+    const uint8_t *tx;
+    uint8_t txlen;
+
+    switch( i2c_slave_poll() )
+    {
+        case I2C_SLAVE_RX:
+            if( i2c_read_burst(SLAVE, sizeof(rx), rx) == I2C_OK )
+            {
+                lcd_cop_receive(rx, i2c_slave_count());
+            }
+            break;
+
+        case I2C_SLAVE_TX:
+            tx = lcd_cop_transmit(&txlen);
+            (void)i2c_write_burst(SLAVE, txlen, (uint8_t *)tx);
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+
+/**
+ * @brief    Apply a write transfer to the register map, used by the
+ *           transport
+ * @param    buf: register address followed by the data
+ * @param    len: bytes in buf
+ * @retval   none
+ */
+void lcd_cop_receive(const uint8_t *buf, uint8_t len)
+{
+    if( len == 0 )
+    {
+        return;
+    }
+
+    cop_reg = buf[0];
+
+    for(uint8_t i = 1; i < len; i++)
+    {
+        if( (uint8_t)(cop_reg + i - 1) >= LCD_COP_MAP_SIZE )
+        {
+            cop_map[LCD_COP_STATUS] |= LCD_COP_ST_OVERRUN;
+            break;
+        }
+        lcd_cop_store(cop_reg + i - 1, buf[i]);
+    }
+}
+
+
+
+/**
+ * @brief    Render the changes written since the last call to the LCD
+ * @param    none
+ * @retval   none
+ */
+void lcd_cop_process(void)
+{
+    uint8_t fb[LCD_COP_FB_SIZE];
+    uint8_t cgram[LCD_COP_MAP_SIZE - LCD_COP_CGRAM];
+
+    if( !cop_pending && !cop_glyphs && !lcd_fb_pending() )
+    {
+        return;
+    }
+
+    /* Render from a copy, the host may write the map again meanwhile */
+    lcd_cop_lock();
+
+    uint8_t pending = cop_pending;
+    uint8_t glyphs = cop_glyphs;
+    uint8_t ctrl = cop_map[LCD_COP_CTRL];
+    uint8_t cursor = cop_map[LCD_COP_CURSOR];
+
+    cop_pending = 0;
+    cop_glyphs = 0;
+
+    for(uint8_t i = 0; i < LCD_COP_FB_SIZE; i++)
+    {
+        fb[i] = cop_map[LCD_COP_FB + i];
+    }
+    if( glyphs || (pending & LCD_COP_PEND_INIT) )
+    {
+        for(uint8_t i = 0; i < sizeof(cgram); i++)
+        {
+            cgram[i] = cop_map[LCD_COP_CGRAM + i];
+        }
+    }
+
+    lcd_cop_unlock();
+
+    if( pending & LCD_COP_PEND_INIT )
+    {
+        lcd_init();
+        lcd_fb_invalidate();
+
+        /* A power cycled LCD lost its glyphs */
+        glyphs = 0xFF;
+        pending |= LCD_COP_PEND_FB | LCD_COP_PEND_CTRL;
+    }
+
+    if( pending & LCD_COP_PEND_FB )
+    {
+        for(uint8_t row = 0; row < LCD_FB_ROWS; row++)
+        {
+            lcd_fb_write(row + 1, 1, &fb[row * LCD_FB_COLS], LCD_FB_COLS);
+        }
+    }
+
+    lcdFbState_t state =
+    {
+        .cgram = cgram,
+        .glyphs = glyphs,
+        .send = ( pending & LCD_COP_PEND_CTRL ) ? (LCD_FB_SEND_CTRL | LCD_FB_SEND_BACKLIGHT) : 0,
+        .display = ( (ctrl & LCD_COP_CTRL_DISPLAY) != 0 ),
+        .cursor = ( (ctrl & LCD_COP_CTRL_CURSOR) != 0 ),
+        .blink = ( (ctrl & LCD_COP_CTRL_BLINK) != 0 ),
+        .backlight = ( (ctrl & LCD_COP_CTRL_BACKLIGHT) != 0 ),
+        .row = ( cursor & 0x40 ) ? 2 : 1,
+        .col = (cursor & 0x3F) + 1
+    };
+
+    uint8_t failed = !lcd_fb_render(&state, NULL);
+
+    lcd_cop_lock();
+
+    if( failed )
+    {
+        /* Retried by the next call */
+        cop_map[LCD_COP_STATUS] |= LCD_COP_ST_ERROR;
+        cop_pending |= pending & ~( LCD_COP_PEND_FB );
+        cop_glyphs |= glyphs;
+    }
+    else if( !cop_pending && !cop_glyphs && !lcd_fb_pending() )
+    {
+        cop_map[LCD_COP_STATUS] &= ~( LCD_COP_ST_BUSY );
+    }
+
+    lcd_cop_unlock();
+}
+
+
+
+/**
+ * @brief    Static function to write one register
+ * @param    reg: register address, below LCD_COP_MAP_SIZE
+ * @param    value: value written
+ * @retval   none
+ */
+static void lcd_cop_store(uint8_t reg, uint8_t value)
+{
+    if( reg == LCD_COP_STATUS )
+    {
+        cop_map[LCD_COP_STATUS] &= ~( value & (LCD_COP_ST_ERROR | LCD_COP_ST_OVERRUN) );
+        return;
+    }
+
+    if( reg == LCD_COP_CMD )
+    {
+        if( value == LCD_COP_CMD_CLEAR )
+        {
+            for(uint8_t i = 0; i < LCD_COP_FB_SIZE; i++)
+            {
+                cop_map[LCD_COP_FB + i] = ' ';
+            }
+            cop_pending |= LCD_COP_PEND_FB;
+        }
+        else if( value == LCD_COP_CMD_INIT )
+        {
+            cop_pending |= LCD_COP_PEND_INIT;
+        }
+        else
+        {
+            return;
+        }
+    }
+    else if( reg >= LCD_COP_CGRAM )
+    {
+        value &= 0x1F;
+        cop_glyphs |= 1U << ((reg - LCD_COP_CGRAM) >> 3);
+        cop_map[reg] = value;
+    }
+    else if( (reg >= LCD_COP_FB) && (reg < (LCD_COP_FB + LCD_COP_FB_SIZE)) )
+    {
+        cop_pending |= LCD_COP_PEND_FB;
+        cop_map[reg] = value;
+    }
+    else if( reg == LCD_COP_CTRL )
+    {
+        cop_pending |= LCD_COP_PEND_CTRL;
+        cop_map[reg] = value;
+    }
+    else if( reg == LCD_COP_CURSOR )
+    {
+        cop_pending |= LCD_COP_PEND_CURSOR;
+        cop_map[reg] = value;
+    }
+    else
+    {
+        /* Reserved, reads as 0 */
+        return;
+    }
+
+    cop_map[LCD_COP_STATUS] |= LCD_COP_ST_BUSY;
+}
+
+
+
+/**
+ * @brief    Static function to get the bytes a read transfer returns, the
+ *           register pointer does not advance on reads
+ * @param    len: receives the number of bytes
+ * @retval   first byte to send
+ */
+static const uint8_t *lcd_cop_transmit(uint8_t *len)
+{
+    static const uint8_t past_end = 0xFF;
+
+    if( cop_reg < LCD_COP_MAP_SIZE )
+    {
+        *len = LCD_COP_MAP_SIZE - cop_reg;
+        return &cop_map[cop_reg];
+    }
+
+    *len = 1;
+    return &past_end;
+}
+
+
+
+#if ( USE_LCD_COP_IRQ )
+
+/**
+ * @brief    Static function called by the I2C1 interrupt at the end of a
+ *           write transfer
+ * @param    buf: register address followed by the data
+ * @param    len: bytes in buf
+ * @param    dropped: bytes that did not fit the receive buffer
+ * @retval   none
+ */
+static void lcd_cop_received(const uint8_t *buf, uint8_t len, uint8_t dropped)
+{
+    lcd_cop_receive(buf, len);
+
+    if( dropped )
+    {
+        cop_map[LCD_COP_STATUS] |= LCD_COP_ST_OVERRUN;
+    }
+}
+
+#endif
+
+
+
+/**
+ * @brief    Static function to keep the I2C1 interrupt out of the shared
+ *           state, only needed with USE_LCD_COP_IRQ
+ * @param    none
+ * @retval   none
+ */
+static void lcd_cop_lock(void)
+{
+    #if ( USE_LCD_COP_IRQ )
+    i2c_slave_irq_lock();
+    #endif
+}
+
+
+
+/**
+ * @brief    Static function to end lcd_cop_lock()
+ * @param    none
+ * @retval   none
+ */
+static void lcd_cop_unlock(void)
+{
+    #if ( USE_LCD_COP_IRQ )
+    i2c_slave_irq_unlock();
+    #endif
+}
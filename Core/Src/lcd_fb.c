@@ -0,0 +1,295 @@
+/**
+  ******************************************************************************
+  * @file    lcd_fb.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Shadow framebuffer of the 16x2 display. See lcd_fb.h.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include "lcd_fb.h"
+
+
+/* Unchanged characters sent to join two runs, cheaper than a cursor move */
+#define LCD_FB_GAP                  1
+
+
+/* Characters wanted on the display */
+static uint8_t fb_want[LCD_FB_ROWS][LCD_FB_COLS];
+
+/* Characters the LCD shows, valid while fb_valid is set */
+static uint8_t fb_shown[LCD_FB_ROWS][LCD_FB_COLS];
+static uint8_t fb_valid = 0;
+
+/* Set by a write that changed a character since the last flush */
+static uint8_t fb_dirty = 1;
+
+
+
+/**
+ * @brief    Fill the framebuffer with spaces and invalidate it, the first
+ *           flush then clears the whole display
+ * @param    none
+ * @retval   none
+ */
+void lcd_fb_init(void)
+{
+    lcd_fb_fill(' ');
+    lcd_fb_invalidate();
+}
+
+
+
+/**
+ * @brief    Write len characters starting at row, col, clipped at the end
+ *           of the row
+ * @param    row: First row (1), second row (2)
+ * @param    col: any value from 1-16
+ * @param    buf: pointer to the characters
+ * @param    len: number of characters
+ * @retval   none
+ */
+void lcd_fb_write(uint8_t row, uint8_t col, const uint8_t *buf, size_t len)
+{
+    if( (row < 1) || (row > LCD_FB_ROWS) || (col < 1) || (col > LCD_FB_COLS) )
+    {
+        return;
+    }
+
+    uint8_t *dst = &fb_want[row - 1][col - 1];
+
+    if( len > (size_t)(LCD_FB_COLS - col + 1) )
+    {
+        len = LCD_FB_COLS - col + 1;
+    }
+
+    /* Rewriting what is there already costs no flush */
+    for(; len; len--, dst++, buf++)
+    {
+        if( *dst != *buf )
+        {
+            *dst = *buf;
+            fb_dirty = 1;
+        }
+    }
+}
+
+
+
+/**
+ * @brief    Set every character of the framebuffer
+ * @param    ch: character, ' ' clears
+ * @retval   none
+ */
+void lcd_fb_fill(uint8_t ch)
+{
+    for(uint8_t row = 0; row < LCD_FB_ROWS; row++)
+    {
+        for(uint8_t col = 0; col < LCD_FB_COLS; col++)
+        {
+            if( fb_want[row][col] != ch )
+            {
+                fb_want[row][col] = ch;
+                fb_dirty = 1;
+            }
+        }
+    }
+}
+
+
+
+/**
+ * @brief    Get a character of the framebuffer
+ * @param    row: First row (1), second row (2)
+ * @param    col: any value from 1-16
+ * @retval   character, ' ' outside the display
+ */
+uint8_t lcd_fb_get(uint8_t row, uint8_t col)
+{
+    if( (row < 1) || (row > LCD_FB_ROWS) || (col < 1) || (col > LCD_FB_COLS) )
+    {
+        return ' ';
+    }
+    return fb_want[row - 1][col - 1];
+}
+
+
+
+/**
+ * @brief    Forget what the LCD shows so the next flush sends everything.
+ *           Call after lcd_init(), lcd_clear() or prints that bypass the
+ *           framebuffer.
+ * @param    none
+ * @retval   none
+ */
+void lcd_fb_invalidate(void)
+{
+    fb_valid = 0;
+    fb_dirty = 1;
+}
+
+
+
+/**
+ * @brief    Check for changes not sent to the LCD yet
+ * @param    none
+ * @retval   1 when a flush is needed, 0 otherwise
+ */
+uint8_t lcd_fb_pending(void)
+{
+    return fb_dirty;
+}
+
+
+
+/**
+ * @brief    Send the characters that differ from what the LCD shows. A
+ *           bus error (see lcd_bus_status(), consumed here) invalidates
+ *           the framebuffer so the next flush repaints.
+ * @param    none
+ * @retval   number of characters sent
+ */
+uint16_t lcd_fb_flush(void)
+{
+    uint16_t sent = 0;
+    uint8_t batch = 0;
+
+    if( !fb_dirty )
+    {
+        return 0;
+    }
+
+    for(uint8_t row = 0; row < LCD_FB_ROWS; row++)
+    {
+        uint8_t col = 0;
+
+        while( col < LCD_FB_COLS )
+        {
+            if( fb_valid && (fb_want[row][col] == fb_shown[row][col]) )
+            {
+                col++;
+                continue;
+            }
+
+            /* Extend the run over gaps of up to LCD_FB_GAP characters */
+            uint8_t start = col;
+            uint8_t end = col;
+
+            for(col++; (col < LCD_FB_COLS) && ((col - end) <= (LCD_FB_GAP + 1)); col++)
+            {
+                if( !fb_valid || (fb_want[row][col] != fb_shown[row][col]) )
+                {
+                    end = col;
+                }
+            }
+            col = end + 1;
+
+            /* Characters changed back before the flush cost nothing */
+            if( !batch )
+            {
+                lcd_batch_begin();
+                batch = 1;
+            }
+            lcd_write(row + 1, start + 1, &fb_want[row][start], end - start + 1);
+            for(uint8_t i = start; i <= end; i++)
+            {
+                fb_shown[row][i] = fb_want[row][i];
+            }
+            sent += end - start + 1;
+        }
+    }
+
+    if( batch )
+    {
+        lcd_batch_end();
+    }
+
+    fb_valid = 1;
+    fb_dirty = 0;
+
+    if( lcd_bus_status() != I2C_OK )
+    {
+        lcd_fb_invalidate();
+    }
+
+    return sent;
+}
+
+
+
+/**
+ * @brief    Render a display state in the order the LCD needs it: glyphs,
+ *           framebuffer changes, display control, back light, then the
+ *           cursor is put back where drawing moved it from. Consumes
+ *           lcd_bus_status().
+ * @param    state: what to send
+ * @param    sent: receives the number of characters sent, may be NULL
+ * @retval   1 when everything reached the LCD, 0 after a bus error. The
+ *           framebuffer repaints itself, the rest is up to the caller.
+ */
+uint8_t lcd_fb_render(const lcdFbState_t *state, uint16_t *sent)
+{
+    for(uint8_t i = 0; i < 8; i++)
+    {
+        if( state->glyphs & (1U << i) )
+        {
+            lcd_cgram(i, &state->cgram[i * 8]);
+        }
+    }
+    uint8_t failed = ( lcd_bus_status() != I2C_OK );
+
+    /* A failed flush leaves the framebuffer pending */
+    uint16_t chars = lcd_fb_flush();
+    failed |= lcd_fb_pending();
+
+    if( state->send & LCD_FB_SEND_CTRL )
+    {
+        lcd_display_ctrl(state->display, state->cursor, state->blink);
+    }
+
+    #if ( USE_LCD_I2C )
+    if( state->send & LCD_FB_SEND_BACKLIGHT )
+    {
+        lcd_backlight(state->backlight);
+        lcd_flush();
+    }
+    #endif
+
+    /* Nothing is sent when the cursor did not move */
+    if( state->cursor || state->blink )
+    {
+        lcd_goto_xy(state->row, state->col);
+    }
+    failed |= ( lcd_bus_status() != I2C_OK );
+
+    if( sent != NULL )
+    {
+        *sent = chars;
+    }
+
+    return !failed;
+}
@@ -0,0 +1,430 @@
+/**
+  ******************************************************************************
+  * @file    lcd_frame.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Binary framed display updates. See lcd_frame.h for the frame
+  *          format.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include "lcd_frame.h"
+
+
+#define LCD_FRAME_CELLS_TOTAL       ( LCD_FB_ROWS * LCD_FB_COLS )
+
+/* Bytes of a frame after the SOF */
+#define LCD_FRAME_RAW_SIZE          ( LCD_FRAME_MAX_PAYLOAD + 4 )
+
+/* Display state applied but not sent yet */
+#define LCD_FRAME_PEND_CTRL         ( 1U << 0 )
+#define LCD_FRAME_PEND_CURSOR       ( 1U << 1 )
+#define LCD_FRAME_PEND_BACKLIGHT    ( 1U << 2 )
+
+
+/* Parser states */
+typedef enum
+{
+    FRAME_HUNT = 0,             /* waiting for LCD_FRAME_SOF */
+    FRAME_TYPE,
+    FRAME_LEN,
+    FRAME_PAYLOAD,
+    FRAME_CRC_H,
+    FRAME_CRC_L
+} lcdFrameState_t;
+
+
+static lcdFrameState_t frame_state = FRAME_HUNT;
+static uint8_t frame_type = 0;
+static uint8_t frame_len = 0;
+static uint8_t frame_count = 0;
+static uint8_t frame_payload[LCD_FRAME_MAX_PAYLOAD];
+static uint16_t frame_crc = 0;
+static uint16_t frame_crc_rx = 0;
+static uint16_t frame_errors = 0;
+
+/* Bytes since the SOF, scanned again when the frame is rejected */
+static uint8_t frame_raw[LCD_FRAME_RAW_SIZE];
+static uint8_t frame_raw_len = 0;
+
+static uint8_t frame_ctrl = LCD_FRAME_CTRL_DISPLAY;
+static uint8_t frame_cursor = 0;
+static uint8_t frame_backlight = 1;
+static uint8_t frame_cgram[8][8];
+
+/* Glyphs to upload, bit n for character code n */
+static uint8_t frame_glyphs = 0;
+static uint8_t frame_pending = 0;
+
+
+static uint8_t lcd_frame_parse(uint8_t byte);
+static uint8_t lcd_frame_apply(void);
+static void lcd_frame_cell(uint16_t pos, uint8_t ch);
+
+
+
+/**
+ * @brief    Reset the parser and the display state: framebuffer cleared,
+ *           display and backlight on, cursor off
+ * @param    none
+ * @retval   none
+ */
+void lcd_frame_init(void)
+{
+    frame_state = FRAME_HUNT;
+    frame_errors = 0;
+
+    frame_ctrl = LCD_FRAME_CTRL_DISPLAY;
+    frame_cursor = 0;
+    frame_backlight = 1;
+    frame_glyphs = 0;
+    frame_pending = LCD_FRAME_PEND_CTRL | LCD_FRAME_PEND_BACKLIGHT;
+
+    lcd_fb_init();
+}
+
+
+
+/**
+ * @brief    Feed a byte of the stream to the parser
+ * @param    byte: received byte
+ * @retval   none
+ */
+void lcd_frame_putc(uint8_t byte)
+{
+    uint8_t queue[LCD_FRAME_RAW_SIZE];
+    uint8_t head = 0;
+    uint8_t tail = 0;
+
+    queue[tail++] = byte;
+
+    while( head < tail )
+    {
+        if( lcd_frame_parse(queue[head++]) )
+        {
+            continue;
+        }
+
+        /* The SOF was noise or the frame got corrupted, a real frame may
+           start in the bytes after the SOF: scan them again. The queue
+           shrinks by at least the SOF each time. */
+        uint8_t rest = tail - head;
+
+        for(uint8_t i = rest; i > 0; i--)
+        {
+            queue[frame_raw_len + i - 1] = queue[head + i - 1];
+        }
+        for(uint8_t i = 0; i < frame_raw_len; i++)
+        {
+            queue[i] = frame_raw[i];
+        }
+        head = 0;
+        tail = frame_raw_len + rest;
+    }
+}
+
+
+
+/**
+ * @brief    Feed len bytes of the stream to the parser
+ * @param    buf: received bytes
+ * @param    len: number of bytes
+ * @retval   none
+ */
+void lcd_frame_write(const uint8_t *buf, size_t len)
+{
+    for(size_t i = 0; i < len; i++)
+    {
+        lcd_frame_putc(buf[i]);
+    }
+}
+
+
+
+/**
+ * @brief    Check for applied frames not shown on the LCD yet
+ * @param    none
+ * @retval   1 when a flush is needed, 0 otherwise
+ */
+uint8_t lcd_frame_pending(void)
+{
+    return lcd_fb_pending() || frame_pending || frame_glyphs;
+}
+
+
+
+/**
+ * @brief    Send the applied frames to the LCD: glyphs, changed cells,
+ *           display control, backlight and cursor. What failed on the bus
+ *           is sent again by the next flush.
+ * @param    none
+ * @retval   number of characters sent
+ */
+uint16_t lcd_frame_flush(void)
+{
+    uint8_t glyphs = frame_glyphs;
+    uint8_t pending = frame_pending;
+    uint16_t sent;
+
+    lcdFbState_t state =
+    {
+        .cgram = &frame_cgram[0][0],
+        .glyphs = glyphs,
+        .send = ( (pending & LCD_FRAME_PEND_CTRL) ? LCD_FB_SEND_CTRL : 0 ) |
+                ( (pending & LCD_FRAME_PEND_BACKLIGHT) ? LCD_FB_SEND_BACKLIGHT : 0 ),
+        .display = ( (frame_ctrl & LCD_FRAME_CTRL_DISPLAY) != 0 ),
+        .cursor = ( (frame_ctrl & LCD_FRAME_CTRL_CURSOR) != 0 ),
+        .blink = ( (frame_ctrl & LCD_FRAME_CTRL_BLINK) != 0 ),
+        .backlight = frame_backlight,
+        .row = (uint8_t)( frame_cursor / LCD_FB_COLS ) + 1,
+        .col = (uint8_t)( frame_cursor % LCD_FB_COLS ) + 1
+    };
+
+    if( lcd_fb_render(&state, &sent) )
+    {
+        /* Frames applied meanwhile are not lost */
+        frame_glyphs &= ~glyphs;
+        frame_pending &= ~pending;
+    }
+
+    return sent;
+}
+
+
+
+/**
+ * @brief    Get the number of frames rejected for a bad CRC, length or
+ *           type since lcd_frame_init()
+ * @param    none
+ * @retval   rejected frames
+ */
+uint16_t lcd_frame_errors(void)
+{
+    return frame_errors;
+}
+
+
+
+/**
+ * @brief    Update a CRC-16/CCITT-FALSE with a byte, start from 0xFFFF.
+ *           Also for senders building frames.
+ * @param    crc: CRC so far
+ * @param    byte: next byte
+ * @retval   updated CRC
+ */
+uint16_t lcd_frame_crc(uint16_t crc, uint8_t byte)
+{
+    /* One nibble at a time, 16 entries instead of 256 */
+    static const uint16_t nibble[16] =
+    {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+    };
+
+    crc = (uint16_t)( (crc << 4) ^ nibble[(crc >> 12) ^ (byte >> 4)] );
+    crc = (uint16_t)( (crc << 4) ^ nibble[(crc >> 12) ^ (byte & 0x0F)] );
+
+    return crc;
+}
+
+
+
+/**
+ * @brief    Static function to run the parser on a byte
+ * @param    byte: received byte
+ * @retval   0 when the frame in progress was rejected for its length or
+ *           CRC (frame_raw holds its bytes after the SOF), 1 otherwise
+ */
+static uint8_t lcd_frame_parse(uint8_t byte)
+{
+    if( frame_state != FRAME_HUNT )
+    {
+        frame_raw[frame_raw_len++] = byte;
+    }
+
+    switch( frame_state )
+    {
+        case FRAME_HUNT:
+            if( byte == LCD_FRAME_SOF )
+            {
+                frame_crc = 0xFFFF;
+                frame_raw_len = 0;
+                frame_state = FRAME_TYPE;
+            }
+            break;
+
+        case FRAME_TYPE:
+            frame_type = byte;
+            frame_crc = lcd_frame_crc(frame_crc, byte);
+            frame_state = FRAME_LEN;
+            break;
+
+        case FRAME_LEN:
+            if( byte > LCD_FRAME_MAX_PAYLOAD )
+            {
+                frame_errors++;
+                frame_state = FRAME_HUNT;
+                return 0;
+            }
+            frame_len = byte;
+            frame_count = 0;
+            frame_crc = lcd_frame_crc(frame_crc, byte);
+            frame_state = ( byte == 0 ) ? FRAME_CRC_H : FRAME_PAYLOAD;
+            break;
+
+        case FRAME_PAYLOAD:
+            frame_payload[frame_count++] = byte;
+            frame_crc = lcd_frame_crc(frame_crc, byte);
+            if( frame_count == frame_len )
+            {
+                frame_state = FRAME_CRC_H;
+            }
+            break;
+
+        case FRAME_CRC_H:
+            frame_crc_rx = (uint16_t)( byte << 8 );
+            frame_state = FRAME_CRC_L;
+            break;
+
+        case FRAME_CRC_L:
+            frame_crc_rx |= byte;
+            frame_state = FRAME_HUNT;
+
+            if( frame_crc_rx != frame_crc )
+            {
+                frame_errors++;
+                return 0;
+            }
+
+            /* A valid frame that makes no sense is not scanned again */
+            if( !lcd_frame_apply() )
+            {
+                frame_errors++;
+            }
+            break;
+
+        default:
+            frame_state = FRAME_HUNT;
+            break;
+    }
+
+    return 1;
+}
+
+
+
+/**
+ * @brief    Static function to apply a frame that passed the CRC
+ * @param    none
+ * @retval   1 if applied, 0 for an unknown type or a malformed payload
+ */
+static uint8_t lcd_frame_apply(void)
+{
+    const uint8_t *p = frame_payload;
+    uint8_t len = frame_len;
+
+    switch( frame_type )
+    {
+        case LCD_FRAME_CELLS:
+            if( len < 1 )
+            {
+                return 0;
+            }
+            for(uint8_t i = 1; i < len; i++)
+            {
+                lcd_frame_cell((uint16_t)( p[0] + i - 1 ), p[i]);
+            }
+            return 1;
+
+        case LCD_FRAME_RLE:
+            if( (len < 1) || !(len & 0x01) )
+            {
+                return 0;
+            }
+            for(uint16_t pos = p[0], i = 1; i < len; i += 2)
+            {
+                for(uint8_t n = 0; n < p[i]; n++)
+                {
+                    lcd_frame_cell(pos++, p[i + 1]);
+                }
+            }
+            return 1;
+
+        case LCD_FRAME_CGRAM:
+            if( (len != 9) || (p[0] > 7) )
+            {
+                return 0;
+            }
+            for(uint8_t i = 0; i < 8; i++)
+            {
+                frame_cgram[p[0]][i] = p[i + 1] & 0x1F;
+            }
+            frame_glyphs |= 1U << p[0];
+            return 1;
+
+        case LCD_FRAME_CTRL:
+            if( (len < 1) || (len > 2) || ((len == 2) && (p[1] >= LCD_FRAME_CELLS_TOTAL)) )
+            {
+                return 0;
+            }
+            frame_ctrl = p[0] & ( LCD_FRAME_CTRL_DISPLAY | LCD_FRAME_CTRL_CURSOR | LCD_FRAME_CTRL_BLINK );
+            if( len == 2 )
+            {
+                frame_cursor = p[1];
+            }
+            frame_pending |= LCD_FRAME_PEND_CTRL | LCD_FRAME_PEND_CURSOR;
+            return 1;
+
+        case LCD_FRAME_BACKLIGHT:
+            if( len != 1 )
+            {
+                return 0;
+            }
+            frame_backlight = ( p[0] != 0 );
+            frame_pending |= LCD_FRAME_PEND_BACKLIGHT;
+            return 1;
+
+        default:
+            return 0;
+    }
+}
+
+
+
+/**
+ * @brief    Static function to write a character to a cell position
+ * @param    pos: cell position, dropped past the last cell
+ * @param    ch: character
+ * @retval   none
+ */
+static void lcd_frame_cell(uint16_t pos, uint8_t ch)
+{
+    if( pos < LCD_FRAME_CELLS_TOTAL )
+    {
+        lcd_fb_write((uint8_t)( pos / LCD_FB_COLS ) + 1, (uint8_t)( pos % LCD_FB_COLS ) + 1, &ch, 1);
+    }
+}
@@ -0,0 +1,358 @@
+/**
+  ******************************************************************************
+  * @file    lcd_marquee.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Ticker paced by TIM2. See lcd_marquee.h.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include <string.h>
+#include "lcd_marquee.h"
+
+
+/* TIM2 runs from PCLK1 x2 since APB1 is divided */
+#define LCD_MARQUEE_TIMCLK_HZ       72000000UL
+
+/* TIM2 counts at 10 kHz */
+#define LCD_MARQUEE_COUNT_HZ        10000UL
+
+#define LCD_MARQUEE_ROWS            2
+
+/* Text of one row, repeated every period characters */
+typedef struct
+{
+    const char *text;
+    uint16_t len;
+    uint16_t period;
+
+    /* Character of the text at the left edge of the display */
+    uint16_t pos;
+} lcdMarqueeRow_t;
+
+
+static lcdMarqueeRow_t marq_row[LCD_MARQUEE_ROWS];
+
+/* What the marquee wrote into DDRAM, valid while marq_drawn is set */
+static uint8_t marq_ddram[LCD_MARQUEE_ROWS][LCD_DDRAM_COLS];
+static uint8_t marq_drawn = 0;
+
+static uint8_t marq_dir = 0;
+static uint8_t marq_running = 0;
+
+/* Incremented by TIM2, marq_done follows it in thread mode */
+static volatile uint16_t marq_ticks = 0;
+static uint16_t marq_done = 0;
+
+static uint32_t marq_steps = 0;
+
+
+static uint8_t lcd_marquee_char(const lcdMarqueeRow_t *row, uint8_t offset);
+static void lcd_marquee_draw(void);
+static void lcd_marquee_step(void);
+static void lcd_marquee_refill(uint8_t row, uint8_t col, uint8_t ch);
+static void lcd_marquee_timer(void);
+
+
+
+/**
+ * @brief    Show the texts from their first character and start TIM2
+ * @param    row1: text of the first row, NULL leaves the row blank. Must
+ *           stay valid until lcd_marquee_stop().
+ * @param    row2: text of the second row, NULL leaves the row blank
+ * @param    dir: text moves to the right (1), to the left (0)
+ * @retval   none
+ */
+void lcd_marquee_start(const char *row1, const char *row2, uint8_t dir)
+{
+    const char *text[LCD_MARQUEE_ROWS] = { row1, row2 };
+
+    lcd_marquee_stop();
+
+    for(uint8_t i = 0; i < LCD_MARQUEE_ROWS; i++)
+    {
+        marq_row[i].text = text[i];
+        marq_row[i].len = text[i] ? (uint16_t)strlen(text[i]) : 0;
+        marq_row[i].period = marq_row[i].len ? (uint16_t)(marq_row[i].len + LCD_MARQUEE_GAP) : 1;
+        marq_row[i].pos = 0;
+    }
+
+    marq_dir = dir;
+    marq_steps = 0;
+    marq_done = marq_ticks;
+    marq_running = 1;
+
+    lcd_marquee_draw();
+    lcd_marquee_timer();
+}
+
+
+
+/**
+ * @brief    Stop TIM2. The display keeps its shift, lcd_clear() or
+ *           lcd_view_set(1) undo it.
+ * @param    none
+ * @retval   none
+ */
+void lcd_marquee_stop(void)
+{
+    if( !marq_running )
+    {
+        return;
+    }
+
+    TIM2->DIER = 0;
+    TIM2->CR1 = 0;
+    NVIC_DisableIRQ(TIM2_IRQn);
+
+    marq_running = 0;
+}
+
+
+
+/**
+ * @brief    Draw the steps TIM2 counted since the last call. Call it from
+ *           the main loop. A bus error is repaired by the next step.
+ * @param    none
+ * @retval   number of steps drawn
+ */
+uint16_t lcd_marquee_process(void)
+{
+    if( !marq_running )
+    {
+        return 0;
+    }
+
+    uint16_t due = (uint16_t)( marq_ticks - marq_done );
+
+    if( !due )
+    {
+        return 0;
+    }
+    marq_done += due;
+    marq_steps += due;
+
+    /* A bus error leaves the shift unknown and DDRAM in doubt */
+    if( lcd_shift() == LCD_SHIFT_UNKNOWN )
+    {
+        marq_drawn = 0;
+    }
+
+    if( !marq_drawn || (due > LCD_MARQUEE_CATCHUP) )
+    {
+        for(uint8_t i = 0; i < LCD_MARQUEE_ROWS; i++)
+        {
+            lcdMarqueeRow_t *row = &marq_row[i];
+            uint16_t skip = due % row->period;
+
+            row->pos = marq_dir ? (uint16_t)((row->pos + row->period - skip) % row->period)
+                                : (uint16_t)((row->pos + skip) % row->period);
+        }
+        lcd_marquee_draw();
+        return due;
+    }
+
+    /* Steps after a bus error are left to the redraw of the next call */
+    lcd_batch_begin();
+    for(uint16_t i = 0; (i < due) && (lcd_shift() != LCD_SHIFT_UNKNOWN); i++)
+    {
+        lcd_marquee_step();
+    }
+    lcd_batch_end();
+
+    return due;
+}
+
+
+
+/**
+ * @brief    Get the number of steps drawn since lcd_marquee_start()
+ * @param    none
+ * @retval   steps
+ */
+uint32_t lcd_marquee_steps(void)
+{
+    return marq_steps;
+}
+
+
+
+/**
+ * @brief    TIM2 update interrupt, one per step
+ * @param    none
+ * @retval   none
+ */
+void TIM2_IRQHandler(void)
+{
+    if( TIM2->SR & TIM_SR_UIF )
+    {
+        TIM2->SR = (uint16_t)~TIM_SR_UIF;
+        marq_ticks++;
+    }
+}
+
+
+
+/**
+ * @brief    Static function to get a character of a row
+ * @param    row: row of the marquee
+ * @param    offset: 0-39, columns right of the left edge of the display
+ * @retval   character
+ */
+static uint8_t lcd_marquee_char(const lcdMarqueeRow_t *row, uint8_t offset)
+{
+    uint16_t i = (uint16_t)( (row->pos + offset) % row->period );
+
+    return ( i < row->len ) ? (uint8_t)row->text[i] : ' ';
+}
+
+
+
+/**
+ * @brief    Static function to write all 40 DDRAM columns of both rows,
+ *           from the left edge of the display onwards, at the current
+ *           shift
+ * @param    none
+ * @retval   none
+ */
+static void lcd_marquee_draw(void)
+{
+    uint8_t buf[LCD_DDRAM_COLS];
+
+    lcd_batch_begin();
+
+    if( lcd_shift() == LCD_SHIFT_UNKNOWN )
+    {
+        lcd_home();
+    }
+
+    uint8_t left = lcd_shift();
+
+    for(uint8_t i = 0; i < LCD_MARQUEE_ROWS; i++)
+    {
+        for(uint8_t k = 0; k < LCD_DDRAM_COLS; k++)
+        {
+            buf[k] = lcd_marquee_char(&marq_row[i], k);
+            marq_ddram[i][(left + k) % LCD_DDRAM_COLS] = buf[k];
+        }
+        lcd_view_write(i + 1, left + 1, buf, LCD_DDRAM_COLS);
+    }
+
+    lcd_batch_end();
+
+    marq_drawn = ( lcd_shift() != LCD_SHIFT_UNKNOWN );
+}
+
+
+
+/**
+ * @brief    Static function to move the text one column. DDRAM holds the
+ *           40 characters from the left edge of the display onwards, the
+ *           column that leaves that range is refilled while off screen.
+ * @param    none
+ * @retval   none
+ */
+static void lcd_marquee_step(void)
+{
+    uint8_t left = lcd_shift();
+
+    if( marq_dir )
+    {
+        /* The column left of the display comes into view, it gets the
+           character before the left edge */
+        uint8_t col = (uint8_t)( (left + LCD_DDRAM_COLS - 1) % LCD_DDRAM_COLS );
+
+        for(uint8_t i = 0; i < LCD_MARQUEE_ROWS; i++)
+        {
+            lcdMarqueeRow_t *row = &marq_row[i];
+
+            row->pos = (uint16_t)( (row->pos + row->period - 1) % row->period );
+            lcd_marquee_refill(i, col, lcd_marquee_char(row, 0));
+        }
+        lcd_shift_display(1);
+    }
+    else
+    {
+        /* The column at the left edge goes off screen, it gets the
+           character 39 columns right of the new left edge */
+        lcd_shift_display(0);
+
+        for(uint8_t i = 0; i < LCD_MARQUEE_ROWS; i++)
+        {
+            lcdMarqueeRow_t *row = &marq_row[i];
+
+            row->pos = (uint16_t)( (row->pos + 1) % row->period );
+            lcd_marquee_refill(i, left, lcd_marquee_char(row, LCD_DDRAM_COLS - 1));
+        }
+    }
+}
+
+
+
+/**
+ * @brief    Static function to write one character into a DDRAM column
+ *           unless it holds it already. Consecutive refills of a row
+ *           follow the address counter and need no cursor move.
+ * @param    row: row of the marquee
+ * @param    col: DDRAM column 0-39
+ * @param    ch: character
+ * @retval   none
+ */
+static void lcd_marquee_refill(uint8_t row, uint8_t col, uint8_t ch)
+{
+    if( marq_ddram[row][col] != ch )
+    {
+        lcd_write(row + 1, col + 1, &ch, 1);
+        marq_ddram[row][col] = ch;
+    }
+}
+
+
+
+/**
+ * @brief    Static function to start TIM2 with an update interrupt every
+ *           LCD_MARQUEE_STEP_MS
+ * @param    none
+ * @retval   none
+ */
+static void lcd_marquee_timer(void)
+{
+    RCC->APB1ENR |= RCC_APB1ENR_TIM2EN;
+
+    TIM2->CR1 = 0;
+    TIM2->PSC = (uint16_t)( (LCD_MARQUEE_TIMCLK_HZ / LCD_MARQUEE_COUNT_HZ) - 1 );
+    TIM2->ARR = (uint16_t)( (LCD_MARQUEE_STEP_MS * (LCD_MARQUEE_COUNT_HZ / 1000UL)) - 1 );
+
+    /* Load the prescaler now, UG also sets UIF */
+    TIM2->EGR = TIM_EGR_UG;
+    TIM2->SR = 0;
+
+    TIM2->DIER = TIM_DIER_UIE;
+    TIM2->CR1 = TIM_CR1_CEN;
+
+    NVIC_EnableIRQ(TIM2_IRQn);
+}
@@ -0,0 +1,211 @@
+/**
+  ******************************************************************************
+  * @file    lcd_num.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Numeric field widget for the 1602 LCD driver.
+  *
+  *          Digits are extracted with a multiply by the reciprocal of 10
+  *          (0xCCCCCCCD / 2^35, exact for every 32-bit value) which maps to
+  *          a single UMULL instead of a call to __aeabi_uidiv. The new
+  *          characters are compared against the ones on screen and only the
+  *          changed runs are written, so 1299 -> 1300 costs three cells.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include "lcd.h"
+#include "lcd_num.h"
+
+
+/* Marks a cell whose content on the LCD is not known */
+#define LCD_NUM_UNKNOWN             0x00
+
+
+static uint8_t lcd_num_render(const lcdNum_t *num, int32_t value, uint8_t *cell);
+
+
+
+/**
+ * @brief    Initialize a right aligned numeric field. Nothing is written
+ *           until the first lcd_num_set().
+ * @param    num: field to initialize
+ * @param    row: First row (1), second row (2)
+ * @param    col: column of the leftmost cell, 1-16
+ * @param    width: number of cells, 1 to LCD_NUM_MAX_WIDTH
+ * @param    frac: digits after the decimal point, 0 for an integer field
+ * @retval   none
+ */
+void lcd_num_init(lcdNum_t *num, uint8_t row, uint8_t col, uint8_t width, uint8_t frac)
+{
+    if( width > LCD_NUM_MAX_WIDTH )
+    {
+        width = LCD_NUM_MAX_WIDTH;
+    }
+
+    num->row = row;
+    num->col = col;
+    num->width = width;
+    num->frac = frac;
+
+    lcd_num_invalidate(num);
+}
+
+
+
+/**
+ * @brief    Render a value into the field, only the cells that differ
+ *           from the previous value are sent to the LCD. A value that
+ *           does not fit is shown as '#' in every cell. A bus error (see
+ *           lcd_bus_status(), consumed here) invalidates the field so
+ *           the next call rewrites every cell.
+ * @param    num: field to update
+ * @param    value: value to show, scaled by 10^frac
+ * @retval   none
+ */
+void lcd_num_set(lcdNum_t *num, int32_t value)
+{
+    uint8_t cell[LCD_NUM_MAX_WIDTH];
+
+    if( !lcd_num_render(num, value, cell) )
+    {
+        for(uint8_t i = 0; i < num->width; i++)
+        {
+            cell[i] = '#';
+        }
+    }
+
+    uint8_t i = 0;
+    uint8_t batched = 0;
+
+    while( i < num->width )
+    {
+        if( cell[i] == num->shown[i] )
+        {
+            i++;
+            continue;
+        }
+
+        /* Run of changed cells */
+        uint8_t start = i;
+        while( (i < num->width) && (cell[i] != num->shown[i]) )
+        {
+            num->shown[i] = cell[i];
+            i++;
+        }
+
+        /* Several runs share one bus transaction */
+        if( !batched )
+        {
+            lcd_batch_begin();
+            batched = 1;
+        }
+        lcd_write(num->row, num->col + start, &cell[start], i - start);
+    }
+
+    if( batched )
+    {
+        lcd_batch_end();
+    }
+
+    if( lcd_bus_status() != I2C_OK )
+    {
+        lcd_num_invalidate(num);
+    }
+}
+
+
+
+/**
+ * @brief    Forget what the field shows so the next lcd_num_set() rewrites
+ *           every cell, e.g. after lcd_clear()
+ * @param    num: field to invalidate
+ * @retval   none
+ */
+void lcd_num_invalidate(lcdNum_t *num)
+{
+    for(uint8_t i = 0; i < LCD_NUM_MAX_WIDTH; i++)
+    {
+        num->shown[i] = LCD_NUM_UNKNOWN;
+    }
+}
+
+
+
+/**
+ * @brief    Static function to convert value into right aligned characters
+ * @param    num: field giving the width and the decimal places
+ * @param    value: value to convert, scaled by 10^frac
+ * @param    cell: receives num->width characters
+ * @retval   1 if the value fits in the field, 0 otherwise
+ */
+static uint8_t lcd_num_render(const lcdNum_t *num, int32_t value, uint8_t *cell)
+{
+    uint32_t mag = (value < 0) ? (0UL - (uint32_t)value) : (uint32_t)value;
+    int8_t pos = num->width - 1;
+    uint8_t ndigits = 0;
+
+    /* Emit digits from the right until the value is exhausted and the
+       integer digit in front of the decimal point has been written */
+    do
+    {
+        if( pos < 0 )
+        {
+            return 0;
+        }
+
+        if( num->frac && (ndigits == num->frac) )
+        {
+            cell[pos--] = '.';
+            if( pos < 0 )
+            {
+                return 0;
+            }
+        }
+
+        /* mag / 10 and mag % 10 without a divide */
+        uint32_t q = (uint32_t)(((uint64_t)mag * 0xCCCCCCCDULL) >> 35);
+        cell[pos--] = '0' + (uint8_t)(mag - (q * 10));
+        mag = q;
+        ndigits++;
+    } while( mag || (ndigits <= num->frac) );
+
+    if( value < 0 )
+    {
+        if( pos < 0 )
+        {
+            return 0;
+        }
+        cell[pos--] = '-';
+    }
+
+    while( pos >= 0 )
+    {
+        cell[pos--] = ' ';
+    }
+
+    return 1;
+}
@@ -0,0 +1,390 @@
+/**
+  ******************************************************************************
+  * @file    lcd_printf.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Formatted printing for the 1602 LCD driver. See lcd_printf.h for
+  *          the supported conversions.
+  *
+  *          Literal text is written straight from the format string, numbers
+  *          are emitted most significant digit first by repeated subtraction
+  *          of powers of ten, so no digit buffer and no division is needed.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include "lcd.h"
+#include "lcd_printf.h"
+
+
+/* Characters in one DDRAM line */
+#define LCD_PRINTF_LINE_LEN         40
+
+/* Format flags */
+#define LCD_PRINTF_LEFT             ( 1U << 0 )
+#define LCD_PRINTF_ZERO             ( 1U << 1 )
+#define LCD_PRINTF_UPPER            ( 1U << 2 )
+
+
+typedef struct
+{
+    uint8_t row;
+    uint8_t col;
+} lcdPrintfCtx_t;
+
+
+static const uint32_t pow10_tbl[10] =
+{
+    1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL,
+    1000000UL, 10000000UL, 100000000UL, 1000000000UL
+};
+
+
+static void lcd_printf_put(lcdPrintfCtx_t *ctx, const uint8_t *buf, size_t len);
+static void lcd_printf_pad(lcdPrintfCtx_t *ctx, uint8_t ch, uint8_t count);
+static void lcd_printf_num(lcdPrintfCtx_t *ctx, uint32_t value, uint8_t neg, uint8_t base,
+                           uint8_t frac, uint8_t width, uint8_t flags);
+
+
+
+/**
+ * @brief    Print formatted text starting at row, col in a single bus
+ *           transaction. Output past the 40 character DDRAM line is dropped.
+ * @param    row: First row (1), second row (2)
+ * @param    col: any value from 1-16
+ * @param    fmt: format string, see lcd_printf.h for the conversions
+ * @retval   none
+ */
+void lcd_printf(uint8_t row, uint8_t col, const char *fmt, ...)
+{
+    va_list args;
+
+    va_start(args, fmt);
+    lcd_vprintf(row, col, fmt, args);
+    va_end(args);
+}
+
+
+
+/**
+ * @brief    lcd_printf() taking a va_list
+ * @param    row: First row (1), second row (2)
+ * @param    col: any value from 1-16
+ * @param    fmt: format string, see lcd_printf.h for the conversions
+ * @param    args: arguments for fmt
+ * @retval   none
+ */
+void lcd_vprintf(uint8_t row, uint8_t col, const char *fmt, va_list args)
+{
+    lcdPrintfCtx_t ctx = { row, col };
+
+    lcd_batch_begin();
+
+    while( *fmt != '\0' )
+    {
+        /* Literal run, written straight from the format string */
+        const char *run = fmt;
+        while( (*fmt != '\0') && (*fmt != '%') )
+        {
+            fmt++;
+        }
+        lcd_printf_put(&ctx, (const uint8_t *)run, fmt - run);
+
+        if( *fmt == '\0' )
+        {
+            break;
+        }
+        fmt++;
+
+        /* Flags */
+        uint8_t flags = 0;
+        for(;; fmt++)
+        {
+            if( *fmt == '-' )
+            {
+                flags |= LCD_PRINTF_LEFT;
+            }
+            else if( *fmt == '0' )
+            {
+                flags |= LCD_PRINTF_ZERO;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        /* Width */
+        uint8_t width = 0;
+        while( (*fmt >= '0') && (*fmt <= '9') )
+        {
+            width = (width * 10) + (*fmt++ - '0');
+        }
+
+        /* Precision */
+        uint8_t prec = 0;
+        uint8_t has_prec = 0;
+        if( *fmt == '.' )
+        {
+            fmt++;
+            has_prec = 1;
+            while( (*fmt >= '0') && (*fmt <= '9') )
+            {
+                prec = (prec * 10) + (*fmt++ - '0');
+            }
+        }
+
+        /* int and long are both 32 bit on Cortex-M3 */
+        if( *fmt == 'l' )
+        {
+            fmt++;
+        }
+
+        switch( *fmt )
+        {
+        case 'd':
+        case 'i':
+        case 'q':
+        {
+            int32_t value = va_arg(args, int32_t);
+            uint32_t mag = (value < 0) ? (0UL - (uint32_t)value) : (uint32_t)value;
+            uint8_t frac = (*fmt == 'q') ? ((prec > 9) ? 9 : prec) : 0;
+            lcd_printf_num(&ctx, mag, (value < 0), 10, frac, width, flags);
+            break;
+        }
+        case 'u':
+            lcd_printf_num(&ctx, va_arg(args, uint32_t), 0, 10, 0, width, flags);
+            break;
+        case 'X':
+            flags |= LCD_PRINTF_UPPER;
+            /* fall through */
+        case 'x':
+            lcd_printf_num(&ctx, va_arg(args, uint32_t), 0, 16, 0, width, flags);
+            break;
+        case 'c':
+        {
+            uint8_t ch = (uint8_t)va_arg(args, int);
+            uint8_t pad = (width > 1) ? (width - 1) : 0;
+            if( !(flags & LCD_PRINTF_LEFT) )
+            {
+                lcd_printf_pad(&ctx, ' ', pad);
+            }
+            lcd_printf_put(&ctx, &ch, 1);
+            if( flags & LCD_PRINTF_LEFT )
+            {
+                lcd_printf_pad(&ctx, ' ', pad);
+            }
+            break;
+        }
+        case 's':
+        {
+            const char *str = va_arg(args, const char *);
+            uint8_t len = 0;
+
+            /* Like newlib, a NULL string is printed as (null) */
+            if( str == NULL )
+            {
+                str = "(null)";
+            }
+            while( (str[len] != '\0') && (len < LCD_PRINTF_LINE_LEN) && (!has_prec || (len < prec)) )
+            {
+                len++;
+            }
+            uint8_t pad = (width > len) ? (width - len) : 0;
+            if( !(flags & LCD_PRINTF_LEFT) )
+            {
+                lcd_printf_pad(&ctx, ' ', pad);
+            }
+            lcd_printf_put(&ctx, (const uint8_t *)str, len);
+            if( flags & LCD_PRINTF_LEFT )
+            {
+                lcd_printf_pad(&ctx, ' ', pad);
+            }
+            break;
+        }
+        case '%':
+            lcd_printf_put(&ctx, (const uint8_t *)fmt, 1);
+            break;
+        case '\0':
+            /* Dangling % at the end of fmt */
+            fmt--;
+            break;
+        default:
+            /* Unknown conversion, print it as is */
+            lcd_printf_put(&ctx, (const uint8_t *)fmt, 1);
+            break;
+        }
+        fmt++;
+    }
+
+    lcd_batch_end();
+}
+
+
+
+/**
+ * @brief    Static function to print a run of characters at the current
+ *           position, dropping what does not fit in the DDRAM line
+ * @param    ctx: current position
+ * @param    buf: pointer to the characters
+ * @param    len: number of characters
+ * @retval   none
+ */
+static void lcd_printf_put(lcdPrintfCtx_t *ctx, const uint8_t *buf, size_t len)
+{
+    if( ctx->col > LCD_PRINTF_LINE_LEN )
+    {
+        return;
+    }
+    if( len > (size_t)(LCD_PRINTF_LINE_LEN + 1 - ctx->col) )
+    {
+        len = LCD_PRINTF_LINE_LEN + 1 - ctx->col;
+    }
+    if( len == 0 )
+    {
+        return;
+    }
+
+    lcd_write(ctx->row, ctx->col, buf, len);
+    ctx->col += len;
+}
+
+
+
+/**
+ * @brief    Static function to print count copies of ch
+ * @param    ctx: current position
+ * @param    ch: padding character
+ * @param    count: number of copies
+ * @retval   none
+ */
+static void lcd_printf_pad(lcdPrintfCtx_t *ctx, uint8_t ch, uint8_t count)
+{
+    while( count-- )
+    {
+        lcd_printf_put(ctx, &ch, 1);
+    }
+}
+
+
+
+/**
+ * @brief    Static function to print an unsigned magnitude with optional
+ *           sign, decimal point and padding
+ * @param    ctx: current position
+ * @param    value: magnitude to print
+ * @param    neg: prefix with '-' (1) or not (0)
+ * @param    base: 10 or 16
+ * @param    frac: number of digits after the decimal point, 0 for none
+ * @param    width: minimum field width
+ * @param    flags: LCD_PRINTF_LEFT, LCD_PRINTF_ZERO, LCD_PRINTF_UPPER
+ * @retval   none
+ */
+static void lcd_printf_num(lcdPrintfCtx_t *ctx, uint32_t value, uint8_t neg, uint8_t base,
+                           uint8_t frac, uint8_t width, uint8_t flags)
+{
+    /* Count the digits */
+    uint8_t digits = 1;
+    if( base == 16 )
+    {
+        while( (digits < 8) && (value >> (digits * 4)) )
+        {
+            digits++;
+        }
+    }
+    else
+    {
+        while( (digits < 10) && (value >= pow10_tbl[digits]) )
+        {
+            digits++;
+        }
+    }
+
+    /* A fixed-point value always has a digit before the point */
+    if( digits <= frac )
+    {
+        digits = frac + 1;
+    }
+
+    uint8_t len = digits + neg + (frac ? 1 : 0);
+    uint8_t pad = (width > len) ? (width - len) : 0;
+    uint8_t ch;
+
+    if( !(flags & (LCD_PRINTF_LEFT | LCD_PRINTF_ZERO)) )
+    {
+        lcd_printf_pad(ctx, ' ', pad);
+    }
+    if( neg )
+    {
+        ch = '-';
+        lcd_printf_put(ctx, &ch, 1);
+    }
+    if( (flags & LCD_PRINTF_ZERO) && !(flags & LCD_PRINTF_LEFT) )
+    {
+        lcd_printf_pad(ctx, '0', pad);
+    }
+
+    /* Most significant digit first */
+    for(uint8_t i = digits; i != 0; i--)
+    {
+        uint8_t d;
+
+        if( base == 16 )
+        {
+            d = (value >> ((i - 1) * 4)) & 0x0F;
+        }
+        else
+        {
+            d = 0;
+            while( value >= pow10_tbl[i - 1] )
+            {
+                value -= pow10_tbl[i - 1];
+                d++;
+            }
+        }
+
+        if( frac && (i == frac) )
+        {
+            ch = '.';
+            lcd_printf_put(ctx, &ch, 1);
+        }
+
+        if( d < 10 )
+        {
+            ch = '0' + d;
+        }
+        else
+        {
+            ch = ((flags & LCD_PRINTF_UPPER) ? 'A' : 'a') + (d - 10);
+        }
+        lcd_printf_put(ctx, &ch, 1);
+    }
+
+    if( flags & LCD_PRINTF_LEFT )
+    {
+        lcd_printf_pad(ctx, ' ', pad);
+    }
+}
@@ -0,0 +1,133 @@
+/**
+  ******************************************************************************
+  * @file    lcd_prof.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Optional DWT cycle counter profiling of the LCD and I2C driver
+  *          hot paths. See lcd_prof.h.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include "stm32f10x.h"
+#include "lcd_prof.h"
+
+
+#if ( USE_LCD_PROFILING )
+
+lcdProfStat_t lcd_prof[LCD_PROF_POINTS];
+
+
+
+/**
+ * @brief    Enable the DWT cycle counter and clear the statistics. Call
+ *           this before lcd_init().
+ * @param    none
+ * @retval   none
+ */
+void lcd_prof_init(void)
+{
+    /* DWT is gated by TRCENA, a debugger usually sets it but a
+       standalone target does not */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    LCD_PROF_DWT_CTRL |= LCD_PROF_DWT_CYCCNTENA;
+
+    lcd_prof_reset();
+}
+
+
+
+/**
+ * @brief    Clear the statistics of every probe point
+ * @param    none
+ * @retval   none
+ */
+void lcd_prof_reset(void)
+{
+    for(uint8_t p = 0; p < LCD_PROF_POINTS; p++)
+    {
+        lcdProfStat_t *s = &lcd_prof[p];
+
+        s->count = 0;
+        s->min = 0xFFFFFFFF;
+        s->max = 0;
+        s->sum = 0;
+        for(uint8_t b = 0; b < LCD_PROF_BUCKETS; b++)
+        {
+            s->hist[b] = 0;
+        }
+    }
+}
+
+
+
+/**
+ * @brief    Add a measurement to a probe point, used by LCD_PROF_END
+ * @param    point: probe point
+ * @param    cycles: CYCCNT delta
+ * @retval   none
+ */
+void lcd_prof_record(lcdProfPoint_t point, uint32_t cycles)
+{
+    lcdProfStat_t *s = &lcd_prof[point];
+
+    /* floor(log2(cycles)), CLZ on the Cortex-M3 */
+    uint32_t bucket = ( cycles != 0 ) ? (31 - (uint32_t)__builtin_clz(cycles)) : 0;
+
+    if( bucket >= LCD_PROF_BUCKETS )
+    {
+        bucket = LCD_PROF_BUCKETS - 1;
+    }
+
+    s->count++;
+    s->sum += cycles;
+    s->hist[bucket]++;
+
+    if( cycles < s->min )
+    {
+        s->min = cycles;
+    }
+    if( cycles > s->max )
+    {
+        s->max = cycles;
+    }
+}
+
+
+
+/**
+ * @brief    Mean cycles per call of a probe point
+ * @param    point: probe point
+ * @retval   mean in cycles, 0 when the point was never hit
+ */
+uint32_t lcd_prof_mean(lcdProfPoint_t point)
+{
+    const lcdProfStat_t *s = &lcd_prof[point];
+
+    return ( s->count != 0 ) ? (uint32_t)(s->sum / s->count) : 0;
+}
+
+#endif
@@ -0,0 +1,197 @@
+/**
+  ******************************************************************************
+  * @file    lcd_queue.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Lock-free multi-producer message queue for the 1602 LCD driver.
+  *          See lcd_queue.h for configuration.
+  *
+  *          Producers reserve a slot by advancing queue_head with LDREX/STREX,
+  *          fill it, then publish it by setting its ready flag. The consumer
+  *          drains slots strictly in reservation order, so a producer that is
+  *          preempted while filling its slot only delays later messages.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include "stm32f10x.h"
+#include "lcd.h"
+#include "lcd_queue.h"
+
+
+#if ( LCD_QUEUE_SLOTS & (LCD_QUEUE_SLOTS - 1) )
+#error "LCD_QUEUE_SLOTS must be a power of two"
+#endif
+
+
+typedef struct
+{
+    volatile uint8_t ready;
+    uint8_t row;
+    uint8_t col;
+    uint8_t len;
+    uint8_t text[LCD_QUEUE_MSG_LEN];
+} lcdQueueSlot_t;
+
+
+static lcdQueueSlot_t queue_slot[LCD_QUEUE_SLOTS];
+
+/* Next slot to reserve, advanced by producers */
+static volatile uint32_t queue_head = 0;
+
+/* Next slot to render, advanced by the consumer only */
+static volatile uint32_t queue_tail = 0;
+
+
+static uint32_t lcd_queue_ldrex(volatile uint32_t *addr);
+static uint32_t lcd_queue_strex(uint32_t value, volatile uint32_t *addr);
+
+
+
+/**
+ * @brief    Post a message to be printed at row, col. Safe to call from
+ *           any interrupt priority and from thread mode. Never blocks,
+ *           the message is dropped when the queue is full.
+ * @param    row: First row (1), second row (2)
+ * @param    col: any value from 1-16
+ * @param    str: null terminated string, truncated to LCD_QUEUE_MSG_LEN
+ * @retval   1 if the message was queued, 0 if the queue is full
+ */
+uint8_t lcd_post(uint8_t row, uint8_t col, const char *str)
+{
+    uint32_t head;
+
+    /* Reserve a slot, retried only when another producer preempted us
+       between the exclusive load and store */
+    do
+    {
+        head = lcd_queue_ldrex(&queue_head);
+
+        if( (head - queue_tail) >= LCD_QUEUE_SLOTS )
+        {
+            __CLREX();
+            return 0;
+        }
+    } while( lcd_queue_strex(head + 1, &queue_head) );
+
+    lcdQueueSlot_t *slot = &queue_slot[head & (LCD_QUEUE_SLOTS - 1)];
+
+    slot->row = row;
+    slot->col = col;
+
+    uint8_t i = 0;
+    for(; (i < LCD_QUEUE_MSG_LEN) && (str[i] != '\0'); i++)
+    {
+        slot->text[i] = str[i];
+    }
+    slot->len = i;
+
+    /* Message contents must be visible before the slot is published */
+    __DMB();
+    slot->ready = 1;
+
+    return 1;
+}
+
+
+
+/**
+ * @brief    Render every completed message in posting order. Call this
+ *           from the main loop, it is the only place the queue touches
+ *           the LCD.
+ * @param    none
+ * @retval   none
+ */
+void lcd_queue_process(void)
+{
+    while( queue_tail != queue_head )
+    {
+        lcdQueueSlot_t *slot = &queue_slot[queue_tail & (LCD_QUEUE_SLOTS - 1)];
+
+        /* Reserved but still being filled by a preempted producer */
+        if( !slot->ready )
+        {
+            break;
+        }
+        __DMB();
+
+        lcd_write(slot->row, slot->col, slot->text, slot->len);
+
+        /* Release the slot only after it has been rendered */
+        slot->ready = 0;
+        __DMB();
+        queue_tail++;
+    }
+}
+
+
+
+/**
+ * @brief    Exclusive load of a word (LDREX)
+ * @param    addr: address of the word
+ * @retval   value read
+ */
+static uint32_t lcd_queue_ldrex(volatile uint32_t *addr)
+{
+    #if defined ( __arm__ )
+
+    uint32_t result;
+
+    __ASM volatile ("ldrex %0, [%1]" : "=r" (result) : "r" (addr) : "memory");
+    return result;
+
+    #else
+
+    /* Host build, there are no interrupts to race with */
+    return *addr;
+
+    #endif
+}
+
+
+
+/**
+ * @brief    Exclusive store of a word (STREX)
+ * @param    value: value to store
+ * @param    addr: address of the word
+ * @retval   0 if the store succeeded, 1 if the exclusive access was lost
+ */
+static uint32_t lcd_queue_strex(uint32_t value, volatile uint32_t *addr)
+{
+    #if defined ( __arm__ )
+
+    uint32_t result;
+
+    __ASM volatile ("strex %0, %2, [%1]" : "=&r" (result) : "r" (addr), "r" (value) : "memory");
+    return result;
+
+    #else
+
+    *addr = value;
+    return 0;
+
+    #endif
+}
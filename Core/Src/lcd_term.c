@@ -0,0 +1,535 @@
+/**
+  ******************************************************************************
+  * @file    lcd_term.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   VT100/ANSI terminal on the 16x2 display. See lcd_term.h.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include "lcd_term.h"
+
+
+#define LCD_TERM_ESC                0x1B
+
+/* Largest numeric parameter kept */
+#define LCD_TERM_PARAM_MAX          999
+
+/* Cursor mode */
+#define LCD_TERM_CURSOR_SHOW        ( 1U << 0 )
+#define LCD_TERM_CURSOR_BLINK       ( 1U << 1 )
+
+
+/* Parser states */
+typedef enum
+{
+    TERM_TEXT = 0,
+    TERM_ESC,                   /* ESC received */
+    TERM_CSI                    /* ESC [ received, collecting parameters */
+} lcdTermState_t;
+
+
+static lcdTermState_t term_state = TERM_TEXT;
+static uint16_t term_param[LCD_TERM_MAX_PARAMS];
+static uint8_t term_params = 0;
+static uint8_t term_private = 0;
+
+/* Cursor, col is LCD_FB_COLS + 1 after the last column until the next
+   character wraps */
+static uint8_t term_row = 1;
+static uint8_t term_col = 1;
+
+static uint8_t term_cursor = 0;
+
+/* Not shown on the LCD yet */
+static uint8_t term_cursor_moved = 0;
+static uint8_t term_cursor_changed = 0;
+
+
+static void lcd_term_text(uint8_t ch);
+static void lcd_term_csi(uint8_t final);
+static void lcd_term_mode(uint8_t set);
+static void lcd_term_newline(void);
+static void lcd_term_erase(uint8_t row, uint8_t first, uint8_t last);
+static void lcd_term_move(int16_t row, int16_t col);
+static uint16_t lcd_term_arg(uint8_t index, uint16_t def);
+
+
+
+/**
+ * @brief    Reset the terminal: clear screen, cursor home and hidden,
+ *           the next flush repaints everything
+ * @param    none
+ * @retval   none
+ */
+void lcd_term_init(void)
+{
+    lcd_fb_init();
+
+    term_state = TERM_TEXT;
+    term_row = 1;
+    term_col = 1;
+    term_cursor = 0;
+    term_cursor_moved = 1;
+    term_cursor_changed = 1;
+}
+
+
+
+/**
+ * @brief    Interpret a character of the input stream
+ * @param    ch: character, control code or part of an escape sequence
+ * @retval   none
+ */
+void lcd_term_putc(uint8_t ch)
+{
+    /* ESC starts over, CAN and SUB abort a sequence */
+    if( ch == LCD_TERM_ESC )
+    {
+        term_state = TERM_ESC;
+        return;
+    }
+    if( (ch == 0x18) || (ch == 0x1A) )
+    {
+        term_state = TERM_TEXT;
+        return;
+    }
+
+    switch( term_state )
+    {
+        case TERM_ESC:
+            term_state = TERM_TEXT;
+
+            if( ch == '[' )
+            {
+                for(uint8_t i = 0; i < LCD_TERM_MAX_PARAMS; i++)
+                {
+                    term_param[i] = 0;
+                }
+                term_params = 0;
+                term_private = 0;
+                term_state = TERM_CSI;
+            }
+            else if( ch == 'c' )
+            {
+                lcd_term_init();
+            }
+            break;
+
+        case TERM_CSI:
+            if( (ch >= '0') && (ch <= '9') )
+            {
+                if( term_params == 0 )
+                {
+                    term_params = 1;
+                }
+                if( term_params <= LCD_TERM_MAX_PARAMS )
+                {
+                    uint16_t *p = &term_param[term_params - 1];
+
+                    *p = ( *p >= (LCD_TERM_PARAM_MAX / 10) ) ? LCD_TERM_PARAM_MAX : (uint16_t)( (*p * 10) + (ch - '0') );
+                }
+            }
+            else if( ch == ';' )
+            {
+                /* An empty first parameter still counts */
+                term_params = ( term_params == 0 ) ? 2 : (uint8_t)( term_params + 1 );
+                if( term_params > (LCD_TERM_MAX_PARAMS + 1) )
+                {
+                    term_params = LCD_TERM_MAX_PARAMS + 1;
+                }
+            }
+            else if( ch == '?' )
+            {
+                term_private = 1;
+            }
+            else if( (ch >= 0x40) && (ch <= 0x7E) )
+            {
+                term_state = TERM_TEXT;
+                lcd_term_csi(ch);
+            }
+            else if( ch < ' ' )
+            {
+                /* Control codes inside a sequence take effect */
+                lcd_term_text(ch);
+            }
+            /* Intermediate bytes are ignored */
+            break;
+
+        default:
+            lcd_term_text(ch);
+            break;
+    }
+}
+
+
+
+/**
+ * @brief    Interpret len characters of the input stream
+ * @param    buf: pointer to the characters
+ * @param    len: number of characters
+ * @retval   none
+ */
+void lcd_term_write(const uint8_t *buf, size_t len)
+{
+    for(size_t i = 0; i < len; i++)
+    {
+        lcd_term_putc(buf[i]);
+    }
+}
+
+
+
+/**
+ * @brief    Check for changes not shown on the LCD yet
+ * @param    none
+ * @retval   1 when a flush is needed, 0 otherwise
+ */
+uint8_t lcd_term_pending(void)
+{
+    return lcd_fb_pending() || term_cursor_changed || ((term_cursor & LCD_TERM_CURSOR_SHOW) && term_cursor_moved);
+}
+
+
+
+/**
+ * @brief    Send the changed cells, the cursor mode and, when the cursor
+ *           is shown, its position to the LCD. What failed on the bus is
+ *           sent again by the next flush.
+ * @param    none
+ * @retval   number of characters sent
+ */
+uint16_t lcd_term_flush(void)
+{
+    uint16_t sent = lcd_fb_flush();
+
+    /* Drawing moved the LCD cursor */
+    if( sent )
+    {
+        term_cursor_moved = 1;
+    }
+
+    uint8_t show = ( (term_cursor & LCD_TERM_CURSOR_SHOW) != 0 );
+
+    /* ?25l hides the blinking block as well */
+    if( term_cursor_changed )
+    {
+        lcd_display_ctrl(1, show, show && (term_cursor & LCD_TERM_CURSOR_BLINK));
+    }
+
+    /* A hidden cursor may stay anywhere */
+    if( show && (term_cursor_moved || term_cursor_changed) )
+    {
+        lcd_goto_xy(term_row, ( term_col > LCD_FB_COLS ) ? LCD_FB_COLS : term_col);
+        term_cursor_moved = 0;
+    }
+
+    if( lcd_bus_status() != I2C_OK )
+    {
+        term_cursor_changed = 1;
+        term_cursor_moved = 1;
+    }
+    else
+    {
+        term_cursor_changed = 0;
+    }
+
+    return sent;
+}
+
+
+
+/**
+ * @brief    Static function to draw a character or run a control code at
+ *           the cursor
+ * @param    ch: character
+ * @retval   none
+ */
+static void lcd_term_text(uint8_t ch)
+{
+    switch( ch )
+    {
+        case '\r':
+            lcd_term_move(term_row, 1);
+            break;
+
+        case '\n':
+            lcd_term_newline();
+            break;
+
+        case '\b':
+            lcd_term_move(term_row, (int16_t)term_col - 1);
+            break;
+
+        case '\f':
+            lcd_fb_fill(' ');
+            lcd_term_move(1, 1);
+            break;
+
+        default:
+            /* Other control codes are ignored */
+            if( ch < ' ' )
+            {
+                break;
+            }
+            if( term_col > LCD_FB_COLS )
+            {
+                lcd_term_newline();
+            }
+            lcd_fb_write(term_row, term_col, &ch, 1);
+            term_col++;
+            term_cursor_moved = 1;
+            break;
+    }
+}
+
+
+
+/**
+ * @brief    Static function to run a CSI sequence
+ * @param    final: final byte
+ * @retval   none
+ */
+static void lcd_term_csi(uint8_t final)
+{
+    uint16_t n = lcd_term_arg(0, 1);
+
+    if( term_private )
+    {
+        if( (final == 'h') || (final == 'l') )
+        {
+            lcd_term_mode(final == 'h');
+        }
+        return;
+    }
+
+    switch( final )
+    {
+        case 'H':
+        case 'f':
+            lcd_term_move(lcd_term_arg(0, 1), lcd_term_arg(1, 1));
+            break;
+
+        case 'A':
+            lcd_term_move((int16_t)term_row - n, term_col);
+            break;
+
+        case 'B':
+            lcd_term_move((int16_t)term_row + n, term_col);
+            break;
+
+        case 'C':
+            lcd_term_move(term_row, (int16_t)term_col + n);
+            break;
+
+        case 'D':
+            lcd_term_move(term_row, (int16_t)term_col - n);
+            break;
+
+        case 'J':
+            switch( lcd_term_arg(0, 0) )
+            {
+                case 0:
+                    lcd_term_erase(term_row, term_col, LCD_FB_COLS);
+                    for(uint8_t row = term_row + 1; row <= LCD_FB_ROWS; row++)
+                    {
+                        lcd_term_erase(row, 1, LCD_FB_COLS);
+                    }
+                    break;
+
+                case 1:
+                    for(uint8_t row = 1; row < term_row; row++)
+                    {
+                        lcd_term_erase(row, 1, LCD_FB_COLS);
+                    }
+                    lcd_term_erase(term_row, 1, term_col);
+                    break;
+
+                case 2:
+                    lcd_fb_fill(' ');
+                    break;
+
+                default:
+                    break;
+            }
+            break;
+
+        case 'K':
+            switch( lcd_term_arg(0, 0) )
+            {
+                case 0:
+                    lcd_term_erase(term_row, term_col, LCD_FB_COLS);
+                    break;
+
+                case 1:
+                    lcd_term_erase(term_row, 1, term_col);
+                    break;
+
+                case 2:
+                    lcd_term_erase(term_row, 1, LCD_FB_COLS);
+                    break;
+
+                default:
+                    break;
+            }
+            break;
+
+        default:
+            /* SGR and the rest have no meaning on this display */
+            break;
+    }
+}
+
+
+
+/**
+ * @brief    Static function to set or reset the DEC private modes of the
+ *           parameters, ?25 shows the cursor and ?12 blinks it
+ * @param    set: 1 for CSI ? h, 0 for CSI ? l
+ * @retval   none
+ */
+static void lcd_term_mode(uint8_t set)
+{
+    uint8_t cursor = term_cursor;
+
+    for(uint8_t i = 0; (i < term_params) && (i < LCD_TERM_MAX_PARAMS); i++)
+    {
+        uint8_t bit = 0;
+
+        if( term_param[i] == 25 )
+        {
+            bit = LCD_TERM_CURSOR_SHOW;
+        }
+        else if( term_param[i] == 12 )
+        {
+            bit = LCD_TERM_CURSOR_BLINK;
+        }
+
+        cursor = set ? (uint8_t)( cursor | bit ) : (uint8_t)( cursor & ~bit );
+    }
+
+    if( cursor != term_cursor )
+    {
+        term_cursor = cursor;
+        term_cursor_changed = 1;
+    }
+}
+
+
+
+/**
+ * @brief    Static function to move the cursor to column 1 of the next
+ *           row, the rows scroll up from the last one
+ * @param    none
+ * @retval   none
+ */
+static void lcd_term_newline(void)
+{
+    if( term_row < LCD_FB_ROWS )
+    {
+        lcd_term_move(term_row + 1, 1);
+        return;
+    }
+
+    uint8_t line[LCD_FB_COLS];
+
+    for(uint8_t row = 1; row < LCD_FB_ROWS; row++)
+    {
+        for(uint8_t col = 1; col <= LCD_FB_COLS; col++)
+        {
+            line[col - 1] = lcd_fb_get(row + 1, col);
+        }
+        lcd_fb_write(row, 1, line, LCD_FB_COLS);
+    }
+    lcd_term_erase(LCD_FB_ROWS, 1, LCD_FB_COLS);
+
+    lcd_term_move(LCD_FB_ROWS, 1);
+}
+
+
+
+/**
+ * @brief    Static function to fill columns first to last of a row with
+ *           spaces
+ * @param    row: First row (1), second row (2)
+ * @param    first: first column, 1-based
+ * @param    last: last column, clipped at LCD_FB_COLS
+ * @retval   none
+ */
+static void lcd_term_erase(uint8_t row, uint8_t first, uint8_t last)
+{
+    uint8_t spaces[LCD_FB_COLS];
+
+    if( last > LCD_FB_COLS )
+    {
+        last = LCD_FB_COLS;
+    }
+    for(uint8_t col = first; col <= last; col++)
+    {
+        spaces[col - first] = ' ';
+    }
+    if( first <= last )
+    {
+        lcd_fb_write(row, first, spaces, (size_t)( last - first + 1 ));
+    }
+}
+
+
+
+/**
+ * @brief    Static function to move the cursor, clamped to the display
+ * @param    row: row, 1-based
+ * @param    col: column, 1-based
+ * @retval   none
+ */
+static void lcd_term_move(int16_t row, int16_t col)
+{
+    row = ( row < 1 ) ? 1 : ( row > LCD_FB_ROWS ) ? LCD_FB_ROWS : row;
+    col = ( col < 1 ) ? 1 : ( col > LCD_FB_COLS ) ? LCD_FB_COLS : col;
+
+    term_row = (uint8_t)row;
+    term_col = (uint8_t)col;
+    term_cursor_moved = 1;
+}
+
+
+
+/**
+ * @brief    Static function to get a CSI parameter
+ * @param    index: parameter, 0 for the first one
+ * @param    def: value when it is missing or 0
+ * @retval   parameter
+ */
+static uint16_t lcd_term_arg(uint8_t index, uint16_t def)
+{
+    if( (index >= term_params) || (index >= LCD_TERM_MAX_PARAMS) || (term_param[index] == 0) )
+    {
+        return def;
+    }
+
+    return term_param[index];
+}
@@ -0,0 +1,104 @@
+/**
+  ******************************************************************************
+  * @file    lcd_trace.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Optional ITM/SWO event trace of the LCD and I2C drivers. See
+  *          lcd_trace.h for the packet format.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include "stm32f10x.h"
+#include "lcd_prof.h"
+#include "lcd_trace.h"
+
+
+#if ( USE_LCD_TRACE )
+
+/* Write a word to a stimulus port once its FIFO has room */
+#ifndef LCD_TRACE_ITM_PUT
+#define LCD_TRACE_ITM_PUT(port, word)                       \
+    do                                                      \
+    {                                                       \
+        while( ITM->PORT[port].u32 == 0 );                  \
+        ITM->PORT[port].u32 = (word);                       \
+    } while( 0 )
+#endif
+
+
+/* CYCCNT of the previous packet */
+static uint32_t trace_last = 0;
+
+
+
+/**
+ * @brief    Enable the DWT cycle counter used for the timestamps. The ITM
+ *           itself is enabled by the debugger.
+ * @param    none
+ * @retval   none
+ */
+void lcd_trace_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    LCD_PROF_DWT_CTRL |= LCD_PROF_DWT_CYCCNTENA;
+
+    trace_last = LCD_PROF_DWT_CYCCNT;
+}
+
+
+
+/**
+ * @brief    Send a trace packet, used by LCD_TRACE
+ * @param    event: event
+ * @param    data: event data
+ * @retval   none
+ */
+void lcd_trace_event(lcdTraceEvent_t event, uint8_t data)
+{
+    /* Cheap exit when nobody listens */
+    if( !(ITM->TCR & ITM_TCR_ITMENA_Msk) || !(ITM->TER & (1UL << LCD_TRACE_PORT)) )
+    {
+        return;
+    }
+
+    uint32_t now = LCD_PROF_DWT_CYCCNT;
+    uint32_t delta = now - trace_last;
+
+    trace_last = now;
+
+    if( delta > LCD_TRACE_DELTA_MASK )
+    {
+        LCD_TRACE_ITM_PUT(LCD_TRACE_PORT, ((uint32_t)LCD_TRACE_TIME << LCD_TRACE_EVENT_POS) |
+                                          (delta >> LCD_TRACE_DELTA_BITS));
+    }
+
+    LCD_TRACE_ITM_PUT(LCD_TRACE_PORT, ((uint32_t)event << LCD_TRACE_EVENT_POS) |
+                                      ((uint32_t)data << LCD_TRACE_DATA_POS) |
+                                      (delta & LCD_TRACE_DELTA_MASK));
+}
+
+#endif
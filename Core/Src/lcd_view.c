@@ -0,0 +1,178 @@
+/**
+  ******************************************************************************
+  * @file    lcd_view.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Viewport over the 40 DDRAM columns of each LCD line. See
+  *          lcd_view.h.
+  *
+  *          Device used: Bluepill (STM32F103C8x)
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include "lcd_view.h"
+
+
+
+/**
+ * @brief    Write len characters into DDRAM starting at row, col, in one
+ *           bus transaction. Past column 40 the write continues at column
+ *           1 of the same row.
+ * @param    row: First row (1), second row (2)
+ * @param    col: DDRAM column 1-40, on screen or not
+ * @param    buf: pointer to the characters
+ * @param    len: number of characters, at most 40
+ * @retval   none
+ */
+void lcd_view_write(uint8_t row, uint8_t col, const uint8_t *buf, size_t len)
+{
+    if( (row < 1) || (row > 2) || (col < 1) || (col > LCD_DDRAM_COLS) )
+    {
+        return;
+    }
+
+    if( len > LCD_DDRAM_COLS )
+    {
+        len = LCD_DDRAM_COLS;
+    }
+
+    /* The address counter would carry on into the other line */
+    size_t first = LCD_DDRAM_COLS - col + 1;
+
+    if( first > len )
+    {
+        first = len;
+    }
+
+    lcd_batch_begin();
+
+    lcd_write(row, col, buf, first);
+    if( len > first )
+    {
+        lcd_write(row, 1, &buf[first], len - first);
+    }
+
+    lcd_batch_end();
+}
+
+
+
+/**
+ * @brief    Move the viewport by steps columns, one display shift
+ *           instruction each. The viewport wraps around the 40 columns.
+ *           Starts from column 1 when a bus error left the shift unknown.
+ * @param    steps: > 0 to the right (text moves left), < 0 to the left
+ * @retval   none
+ */
+void lcd_view_scroll(int8_t steps)
+{
+    lcd_batch_begin();
+
+    if( lcd_shift() == LCD_SHIFT_UNKNOWN )
+    {
+        lcd_home();
+    }
+
+    /* Shifting the display left shows the columns to the right */
+    for(; steps > 0; steps--)
+    {
+        lcd_shift_display(0);
+    }
+    for(; steps < 0; steps++)
+    {
+        lcd_shift_display(1);
+    }
+
+    lcd_batch_end();
+}
+
+
+
+/**
+ * @brief    Show DDRAM column col at the left edge of the display, with the
+ *           fewest shift instructions, at most 20
+ * @param    col: DDRAM column 1-40
+ * @retval   none
+ */
+void lcd_view_set(uint8_t col)
+{
+    if( (col < 1) || (col > LCD_DDRAM_COLS) )
+    {
+        return;
+    }
+
+    lcd_batch_begin();
+
+    if( lcd_shift() == LCD_SHIFT_UNKNOWN )
+    {
+        lcd_home();
+    }
+
+    uint8_t right = (uint8_t)((col - 1 + LCD_DDRAM_COLS - lcd_shift()) % LCD_DDRAM_COLS);
+
+    if( right <= (LCD_DDRAM_COLS / 2) )
+    {
+        lcd_view_scroll( (int8_t)right );
+    }
+    else
+    {
+        lcd_view_scroll( (int8_t)right - LCD_DDRAM_COLS );
+    }
+
+    lcd_batch_end();
+}
+
+
+
+/**
+ * @brief    Get the DDRAM column shown at the left edge of the display
+ * @param    none
+ * @retval   column 1-40, 0 when a bus error left the shift unknown
+ */
+uint8_t lcd_view_col(void)
+{
+    uint8_t shift = lcd_shift();
+
+    return ( shift == LCD_SHIFT_UNKNOWN ) ? 0 : (uint8_t)(shift + 1);
+}
+
+
+
+/**
+ * @brief    Check whether a DDRAM column is on the display
+ * @param    col: DDRAM column 1-40
+ * @retval   1 if on screen, 0 if off screen or the shift is unknown
+ */
+uint8_t lcd_view_visible(uint8_t col)
+{
+    uint8_t shift = lcd_shift();
+
+    if( (shift == LCD_SHIFT_UNKNOWN) || (col < 1) || (col > LCD_DDRAM_COLS) )
+    {
+        return 0;
+    }
+
+    return ( ((col - 1 + LCD_DDRAM_COLS - shift) % LCD_DDRAM_COLS) < LCD_VIEW_COLS );
+}
@@ -43,6 +43,12 @@
 
 #include "stm32f10x.h"
 #include "lcd.h"
+#include "lcd_cal.h"
+#include "lcd_con.h"
+#include "lcd_cop.h"
+#include "lcd_marquee.h"
+#include "lcd_prof.h"
+#include "lcd_trace.h"
 
 #define DELAY_VAL       10000000
 
@@ -57,7 +63,71 @@ void delay(uint32_t del)
 
 int main()
 {
+    #if ( USE_LCD_PROFILING )
+    lcd_prof_init();
+    #endif
+
+    #if ( USE_LCD_TRACE )
+    lcd_trace_init();
+    #endif
+
+    #if ( USE_LCD_I2C )
+
+    /* Backpacks come as PCF8574 or PCF8574A, fall back to LCD_SLAVE_ADDR
+       when none answers */
+    if( !lcd_discover() )
+    {
+        lcd_init();
+    }
+
+    #if ( USE_LCD_CAL )
+
+    /* Run every display at its own best SCL, new ones are calibrated */
+    for(uint8_t i = 0; lcd_select(i); i++)
+    {
+        if( !lcd_cal_load() )
+        {
+            (void)lcd_calibrate();
+        }
+    }
+    (void)lcd_select(0);
+
+    #endif
+
+    #if ( USE_LCD_COP )
+
+    /* Display co-processor, a host master draws through the register
+       map at STM32F1_SLV_ADDR */
+    lcd_cop_init();
+
+    while(1)
+    {
+        #if !( USE_LCD_COP_IRQ )
+        lcd_cop_poll();
+        #endif
+        lcd_cop_process();
+    }
+
+    #endif
+
+    #else
+
     lcd_init();
+
+    #endif
+
+    #if ( USE_LCD_CONSOLE )
+
+    /* Text console, USART1 input is shown as it arrives */
+    lcd_con_init();
+
+    while(1)
+    {
+        (void)lcd_con_process();
+    }
+
+    #endif
+
     lcd_print_string("16x2 LCD Test");
     delay(DELAY_VAL);
     lcd_clear();
@@ -100,31 +170,38 @@ int main()
         lcd_clear();
         lcd_display_ctrl(1, 0, 0);
 
-        lcd_print_string("Shift right >>");
-        for(uint8_t i = 0; i < 16; i++)
+        /* Shift demos, TIM2 paces the marquee while the loop is free */
+        lcd_marquee_start("Shift right >>", NULL, 1);
+        while( lcd_marquee_steps() < 16 )
         {
-            lcd_shift_display(1);
-            delay(1000000);
+            (void)lcd_marquee_process();
         }
+        lcd_marquee_stop();
         lcd_clear();
 
-        lcd_goto_xy(1, 3);
-        lcd_print_string("<< Shift left");
-        for(uint8_t i = 0; i < 16; i++)
+        lcd_marquee_start("<< Shift left", "Text longer than the 40 DDRAM columns of a line, refilled as it scrolls", 0);
+        while( lcd_marquee_steps() < 80 )
         {
-            lcd_shift_display(0);
-            delay(1000000);
+            (void)lcd_marquee_process();
         }
+        lcd_marquee_stop();
         lcd_clear();
 
+        #if ( USE_LCD_I2C )
+
+        /* The back light is switched by the PCF8574 backpack */
         lcd_print_string("Back light test");
         for(uint8_t i = 0; i < 10; i++)
         {
             lcd_backlight(0);
+            lcd_flush();
             delay(1000000);
             lcd_backlight(1);
+            lcd_flush();
             delay(1000000);
         }
         lcd_clear();
+
+        #endif
     }
 }
\ No newline at end of file
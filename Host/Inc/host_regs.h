@@ -0,0 +1,231 @@
+/**
+  ******************************************************************************
+  * @file    host_regs.h
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   In-memory peripheral registers for the host build of the drivers
+  *          and a scripted I2C1 responder behind them.
+  *
+  *          The responder follows the master transmitter and receiver
+  *          sequences of RM0008: a START sets SB, the address byte sets ADDR
+  *          (or AF when no device answers), every data byte sets TXE/BTF
+  *          and a STOP releases the bus. Devices are attached per 7-bit
+  *          address, faults can be scripted with host_i2c_inject().
+  *
+  *          Bus time is accounted from the SCL frequency programmed in
+  *          CR2/CCR, 1 SCL period for START and STOP and 9 per byte. The
+  *          virtual clock host_clock_ns adds the time the drivers spend in
+  *          their delay loops, devices get the time each byte completes.
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+#ifndef __HOST_REGS_H
+#define __HOST_REGS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stm32f10x.h>
+
+
+/* Maximum number of devices attached to the responder */
+#define HOST_I2C_MAX_DEVICES        8
+
+
+typedef enum
+{
+    HOST_I2C_START = 0,         /* START or repeated START */
+    HOST_I2C_ADDR,              /* address byte, data = address + RnW */
+    HOST_I2C_NACK,              /* address not acknowledged */
+    HOST_I2C_WRITE,             /* data byte written by the master */
+    HOST_I2C_READ,              /* data byte read by the master */
+    HOST_I2C_STOP               /* STOP */
+} hostI2cEvent_t;
+
+
+typedef struct
+{
+    uint32_t starts;            /* START and repeated START conditions */
+    uint32_t stops;             /* STOP conditions */
+    uint32_t transactions;      /* acknowledged address phases */
+    uint32_t nacks;             /* address phases nobody answered */
+    uint32_t bytes;             /* bytes on the bus, address bytes included */
+    uint32_t scl_clocks;        /* SCL periods used by the above */
+    uint64_t bus_ns;            /* bus time at the programmed SCL frequency */
+    uint32_t touches;           /* driver accesses to I2C1 */
+} hostI2cStats_t;
+
+
+/* Device behind the responder, t_ns is host_clock_ns at the end of the byte */
+typedef void (*hostI2cWrite_t)(void *ctx, uint8_t data, uint64_t t_ns);
+typedef uint8_t (*hostI2cRead_t)(void *ctx, uint64_t t_ns);
+
+/* Called for every bus event, NULL when not used */
+typedef void (*hostI2cObserver_t)(hostI2cEvent_t event, uint8_t data);
+
+
+extern hostI2cStats_t host_i2c_stats;
+extern hostI2cObserver_t host_i2c_observer;
+
+/* Virtual time, bus time plus delay loops */
+extern uint64_t host_clock_ns;
+
+/* Receives the SWO byte stream of ITM stimulus port writes, NULL when not
+   captured */
+extern FILE *host_swo;
+
+
+
+/**
+ * @brief    Return every register block to its reset value, detach all
+ *           devices, clear scripted faults and statistics
+ * @param    none
+ * @retval   none
+ */
+void host_regs_reset(void);
+
+
+
+/**
+ * @brief    Attach a device to the responder
+ * @param    addr: 7-bit address
+ * @param    write: called with each byte the master writes, may be NULL
+ * @param    read: called for each byte the master reads, may be NULL
+ * @param    ctx: passed back to write and read
+ * @retval   none
+ */
+void host_i2c_attach(uint8_t addr, hostI2cWrite_t write, hostI2cRead_t read, void *ctx);
+
+
+
+/**
+ * @brief    Script a fault: once after_bytes more bytes have been
+ *           transferred, the SR1 bits in sr1_flags (I2C_SR1_AF, ARLO
+ *           or BERR) are raised on the next byte
+ * @param    sr1_flags: SR1 error bits to raise
+ * @param    after_bytes: bytes to let through first
+ * @retval   none
+ */
+void host_i2c_inject(uint16_t sr1_flags, uint32_t after_bytes);
+
+
+
+/**
+ * @brief    Play another master on the bus addressing I2C1 as slave: a
+ *           START, the address, len data bytes, then a STOP. I2C1
+ *           acknowledges an address matching OAR1 while ACK is set. Each
+ *           event is delivered through I2C1_EV_IRQHandler(), the NACK
+ *           ending a read through I2C1_ER_IRQHandler(), while CR2 enables
+ *           the interrupt. The transfer ends early when an event is not
+ *           served, as the remote master would time out.
+ * @param    addr: 7-bit address
+ * @param    read: 0 to write data, 1 to read into data
+ * @param    data: bytes to write, or receives the bytes read
+ * @param    len: number of data bytes
+ * @param    stop: 1 to end with a STOP, 0 for a repeated START next
+ * @retval   data bytes moved, 0 when the address was not acknowledged
+ */
+size_t host_i2c_remote(uint8_t addr, uint8_t read, uint8_t *data, size_t len, uint8_t stop);
+
+
+
+/**
+ * @brief    Let the responder act on the last register write of the
+ *           driver, e.g. a STOP issued right before returning
+ * @param    none
+ * @retval   none
+ */
+void host_i2c_sync(void);
+
+
+
+/**
+ * @brief    Advance the virtual clock, called by the delay loop hooks
+ * @param    ns: time spent
+ * @retval   none
+ */
+void host_delay_ns(uint64_t ns);
+
+
+
+/**
+ * @brief    Write a word to an ITM stimulus port, appends a 4-byte
+ *           software source packet to host_swo
+ * @param    port: stimulus port
+ * @param    word: value written
+ * @retval   none
+ */
+void host_itm_put(uint8_t port, uint32_t word);
+
+
+
+/**
+ * @brief    Called before every driver access to FLASH, unlocks after the
+ *           key sequence and carries out a started page erase
+ * @param    none
+ * @retval   pointer to the FLASH register block
+ */
+FLASH_TypeDef *host_flash_touch(void);
+
+
+
+/**
+ * @brief    Write flags to FLASH SR, which clears the flags written as 1
+ * @param    flags: SR flags to clear
+ * @retval   none
+ */
+void host_flash_sr_clear(uint32_t flags);
+
+
+
+/**
+ * @brief    Give memory used by DMA a 32-bit handle for CPAR/CMAR
+ * @param    p: memory
+ * @retval   handle
+ */
+uint32_t host_dma_addr(volatile void *p);
+
+
+
+/**
+ * @brief    Receive characters on USART1 through DMA1 channel 5, which
+ *           writes them to CMAR and counts CNDTR down, reloading in
+ *           circular mode. IDLE is set after them, USART1_IRQHandler()
+ *           delivers it.
+ * @param    data: characters
+ * @param    len: number of characters
+ * @retval   none
+ */
+void host_usart1_rx(const uint8_t *data, size_t len);
+
+
+
+/**
+ * @brief    SCL frequency programmed in I2C1 CR2/CCR
+ * @param    none
+ * @retval   frequency in Hz, 0 when not configured
+ */
+uint32_t host_i2c_scl_hz(void);
+
+
+#endif /* __HOST_REGS_H */
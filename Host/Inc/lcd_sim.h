@@ -0,0 +1,227 @@
+/**
+  ******************************************************************************
+  * @file    lcd_sim.h
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Host side behavioural model of a 1602 LCD (HD44780U) behind a
+  *          PCF8574 I/O expander, wired the way lcd.c drives it:
+  *
+  *          PCF8574   P0  P1  P2  P3  P4  P5  P6  P7
+  *          LCD       RS  RW  EN  BL  D4  D5  D6  D7
+  *
+  *          Every byte written to the expander is fed to lcd_sim_write(),
+  *          the model latches a nibble on each EN falling edge, assembles
+  *          4-bit instructions and keeps DDRAM, CGRAM, the address counter,
+  *          entry mode and display shift like the controller does.
+  *
+  *          The model runs on a virtual clock set with lcd_sim_set_time()
+  *          and checks each write against the HD44780U timing: instruction
+  *          execution times (BF), EN pulse width and cycle time, and that
+  *          RS/RW/D7-D4 are stable around the EN falling edge. Address setup
+  *          before the EN rising edge (tAS) is only checked in strict mode,
+  *          a single PCF8574 write always changes RS and EN together.
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#ifndef __LCD_SIM_H
+#define __LCD_SIM_H
+
+#include <stdint.h>
+
+
+/* PCF8574 port bits */
+#define LCD_SIM_RS                  ( 1U << 0 )
+#define LCD_SIM_RW                  ( 1U << 1 )
+#define LCD_SIM_EN                  ( 1U << 2 )
+#define LCD_SIM_BL                  ( 1U << 3 )
+
+/* Visible area */
+#define LCD_SIM_ROWS                2
+#define LCD_SIM_COLS                16
+
+/* Characters per DDRAM line */
+#define LCD_SIM_LINE_LEN            40
+
+/* HD44780U timing in ns, fosc = 270 kHz, worst case of both VCC ranges */
+#define LCD_SIM_T_CLEAR             1520000UL   /* clear display, return home */
+#define LCD_SIM_T_EXEC              37000UL     /* other instructions */
+#define LCD_SIM_T_DATA              41000UL     /* data write, 37 us + tADD */
+#define LCD_SIM_T_INIT1             4100000UL   /* first function set after reset */
+#define LCD_SIM_T_INIT2             100000UL    /* second function set after reset */
+#define LCD_SIM_T_PWEH              450UL       /* EN high pulse width */
+#define LCD_SIM_T_CYCE              1000UL      /* EN cycle time */
+
+
+typedef enum
+{
+    LCD_SIM_VIOL_BUSY = 0,      /* nibble written while an instruction executes */
+    LCD_SIM_VIOL_PWEH,          /* EN high shorter than PWEH */
+    LCD_SIM_VIOL_CYCE,          /* EN rising edges closer than tcycE */
+    LCD_SIM_VIOL_HOLD,          /* RS/RW/D7-D4 changed with the EN falling edge */
+    LCD_SIM_VIOL_TAS,           /* RS/RW changed with the EN rising edge (strict) */
+    LCD_SIM_VIOL_COUNT
+} lcdSimViolation_t;
+
+
+typedef struct
+{
+    /* PCF8574 */
+    uint8_t port;               /* output latch */
+
+    /* HD44780U */
+    uint8_t ddram[0x80];
+    uint8_t cgram[0x40];
+    uint8_t ac;                 /* address counter */
+    uint8_t ac_cgram;           /* 1 when the AC addresses CGRAM */
+    uint8_t entry;              /* entry mode, I/D (bit 1), S (bit 0) */
+    uint8_t display;            /* display control, D (bit 2), C (bit 1), B (bit 0) */
+    uint8_t function;           /* function set, DL (bit 4), N (bit 3), F (bit 2) */
+    uint8_t shift;              /* DDRAM column shown in the leftmost cell */
+    uint8_t four_bit;           /* 1 once function set selected the 4-bit interface */
+    uint8_t nibble_hi;          /* first nibble of a 4-bit transfer */
+    uint8_t nibble_pending;     /* 1 when nibble_hi holds the first nibble */
+    uint8_t read_latch;         /* byte being read out in 4-bit mode */
+    uint8_t init_sets;          /* 8-bit function sets seen since reset */
+
+    /* Timing */
+    uint64_t now_ns;            /* virtual time of the next write */
+    uint64_t busy_until_ns;     /* end of the executing instruction */
+    uint64_t en_rise_ns;        /* last EN rising edge */
+    uint8_t en_seen;            /* 1 once EN rose at least once */
+    uint8_t strict;             /* 1 to check tAS too */
+    uint32_t violations[LCD_SIM_VIOL_COUNT];
+    uint64_t first_violation_ns[LCD_SIM_VIOL_COUNT];
+
+    /* Statistics */
+    uint32_t port_writes;       /* bytes written to the PCF8574 */
+    uint32_t port_reads;        /* bytes read from the PCF8574 */
+    uint32_t instructions;      /* instructions executed */
+    uint32_t data_writes;       /* characters written to DDRAM/CGRAM */
+    uint32_t data_reads;        /* characters read from DDRAM/CGRAM */
+} lcdSim_t;
+
+
+
+/**
+ * @brief    Put the model in its power-on state, 8-bit interface,
+ *           display off, DDRAM filled with spaces
+ * @param    sim: model to initialize
+ * @retval   none
+ */
+void lcd_sim_init(lcdSim_t *sim);
+
+
+
+/**
+ * @brief    Set the virtual time of the following writes, time never goes
+ *           backwards
+ * @param    sim: model
+ * @param    ns: time in ns
+ * @retval   none
+ */
+void lcd_sim_set_time(lcdSim_t *sim, uint64_t ns);
+
+
+
+/**
+ * @brief    Total number of timing violations seen so far
+ * @param    sim: model
+ * @retval   sum of sim->violations
+ */
+uint32_t lcd_sim_violation_total(const lcdSim_t *sim);
+
+
+
+/**
+ * @brief    Short name of a timing violation kind
+ * @param    kind: violation kind
+ * @retval   name
+ */
+const char *lcd_sim_violation_name(lcdSimViolation_t kind);
+
+
+
+/**
+ * @brief    Write a byte to the PCF8574 output latch
+ * @param    sim: model
+ * @param    port: new value of P7-P0
+ * @retval   none
+ */
+void lcd_sim_write(lcdSim_t *sim, uint8_t port);
+
+
+
+/**
+ * @brief    Read a byte from the PCF8574. D7-D4 are driven by the LCD while
+ *           RW and EN are high and read as the latch value otherwise.
+ * @param    sim: model
+ * @retval   value of P7-P0
+ */
+uint8_t lcd_sim_read(lcdSim_t *sim);
+
+
+
+/**
+ * @brief    Copy the visible characters of a row, taking the display shift
+ *           and the display on/off control into account
+ * @param    sim: model
+ * @param    row: 0 or 1
+ * @param    buf: receives LCD_SIM_COLS characters and a terminating null
+ * @retval   none
+ */
+void lcd_sim_screen(const lcdSim_t *sim, uint8_t row, char *buf);
+
+
+
+/**
+ * @brief    Return the backlight state driven by P3
+ * @param    sim: model
+ * @retval   1 when on, 0 when off
+ */
+uint8_t lcd_sim_backlight(const lcdSim_t *sim);
+
+
+
+/**
+ * @brief    host_regs.h device write adapter, ctx is the lcdSim_t
+ * @param    ctx: model
+ * @param    data: byte written to the PCF8574
+ * @param    t_ns: time the PCF8574 outputs change
+ * @retval   none
+ */
+void lcd_sim_i2c_write(void *ctx, uint8_t data, uint64_t t_ns);
+
+
+
+/**
+ * @brief    host_regs.h device read adapter, ctx is the lcdSim_t
+ * @param    ctx: model
+ * @param    t_ns: time the PCF8574 inputs are sampled
+ * @retval   byte read from the PCF8574
+ */
+uint8_t lcd_sim_i2c_read(void *ctx, uint64_t t_ns);
+
+
+#endif /* __LCD_SIM_H */
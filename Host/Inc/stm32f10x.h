@@ -0,0 +1,158 @@
+/**
+  ******************************************************************************
+  * @file    stm32f10x.h (host)
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Host build replacement for the device header. Includes the real
+  *          CMSIS/device/stm32f10x.h, then points the peripherals used by the
+  *          drivers at in-memory register blocks (see host_regs.h) so lcd.c
+  *          and i2c.c compile and run unchanged on x86-64 Linux.
+  *
+  *          Every access through I2C1 calls host_i2c1_touch() first, which
+  *          lets the scripted responder react to what the driver wrote since
+  *          the previous access before the driver reads SR1/SR2/DR again.
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+#ifndef __HOST_STM32F10X_H
+#define __HOST_STM32F10X_H
+
+/* Rename the CMSIS intrinsics that expand to Cortex-M instructions, the
+   host versions are defined below */
+#define __DMB                       __host_cmsis_DMB
+#define __CLREX                     __host_cmsis_CLREX
+
+#include_next "stm32f10x.h"
+
+#undef __DMB
+#undef __CLREX
+
+#define __DMB()                     __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __CLREX()                   ((void)0)
+
+
+/* In-memory register blocks, defined in host_regs.c */
+extern RCC_TypeDef host_rcc;
+extern GPIO_TypeDef host_gpioa;
+extern GPIO_TypeDef host_gpiob;
+
+I2C_TypeDef *host_i2c1_touch(void);
+uint16_t host_i2c1_sr1(void);
+uint16_t host_i2c1_sr2(void);
+
+#undef RCC
+#undef GPIOA
+#undef GPIOB
+#undef I2C1
+
+#define RCC                         ( &host_rcc )
+#define GPIOA                       ( &host_gpioa )
+#define GPIOB                       ( &host_gpiob )
+#define I2C1                        ( host_i2c1_touch() )
+
+/* i2c.c reads SR1 and SR2 through these, ADDR clears on SR1 then SR2 */
+#define I2C_SR1_READ()              host_i2c1_sr1()
+#define I2C_SR2_READ()              host_i2c1_sr2()
+
+
+/* lcd_busy_wait() advances the virtual clock, 100 = approx 50us */
+void host_delay_ns(uint64_t ns);
+
+#define LCD_DELAY_HOOK(delay)       host_delay_ns( (uint64_t)(delay) * 500U )
+
+
+/* Core debug and DWT for lcd_prof.c, CYCCNT counts the virtual clock at
+   72 MHz */
+extern CoreDebug_Type host_coredebug;
+extern uint32_t host_dwt_ctrl;
+extern uint64_t host_clock_ns;
+
+#undef CoreDebug
+
+#define CoreDebug                   ( &host_coredebug )
+#define LCD_PROF_DWT_CTRL           host_dwt_ctrl
+#define LCD_PROF_DWT_CYCCNT         ( (uint32_t)((host_clock_ns * 72U) / 1000U) )
+
+
+/* ITM for lcd_trace.c, stimulus port writes are framed as SWO packets
+   and appended to host_swo (see host_regs.h) */
+extern ITM_Type host_itm;
+
+void host_itm_put(uint8_t port, uint32_t word);
+
+#undef ITM
+
+#define ITM                         ( &host_itm )
+#define LCD_TRACE_ITM_PUT(port, word)   host_itm_put( (port), (word) )
+
+
+/* Flash interface for lcd_cal.c, the calibration page is a RAM array. A
+   page erase started through CR completes on the next FLASH access, SR
+   flags are cleared by writing 1 through host_flash_sr_clear() */
+extern uint16_t host_flash_page[512];
+
+FLASH_TypeDef *host_flash_touch(void);
+void host_flash_sr_clear(uint32_t flags);
+
+#undef FLASH
+
+#define FLASH                       ( host_flash_touch() )
+#define LCD_CAL_PAGE_ADDR           ( (uintptr_t)host_flash_page )
+#define LCD_CAL_FLASH_SR_CLEAR(flags)   host_flash_sr_clear(flags)
+
+
+/* USART1 and DMA1 channel 5 for lcd_con.c, plain register blocks fed by
+   host_usart1_rx(). DMA addresses are handles from host_dma_addr() */
+extern USART_TypeDef host_usart1;
+extern DMA_Channel_TypeDef host_dma1_ch5;
+
+uint32_t host_dma_addr(volatile void *p);
+
+#undef USART1
+#undef DMA1_Channel5
+
+#define USART1                      ( &host_usart1 )
+#define DMA1_Channel5               ( &host_dma1_ch5 )
+#define LCD_CON_DMA_ADDR(p)         host_dma_addr( (p) )
+
+
+/* TIM2 for lcd_marquee.c, a plain register block, tools set UIF and call
+   TIM2_IRQHandler() */
+extern TIM_TypeDef host_tim2;
+
+#undef TIM2
+
+#define TIM2                        ( &host_tim2 )
+
+
+/* NVIC for the I2C1 interrupt slave, lcd_con.c and lcd_marquee.c, the
+   host model never raises interrupts, tools call the handlers */
+#undef NVIC_EnableIRQ
+#undef NVIC_DisableIRQ
+
+#define NVIC_EnableIRQ(irq)         ( (void)(irq) )
+#define NVIC_DisableIRQ(irq)        ( (void)(irq) )
+
+
+#endif /* __HOST_STM32F10X_H */
@@ -0,0 +1,409 @@
+/**
+  ******************************************************************************
+  * @file    bench_main.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   lcdbench: runs every public LCD call against the host registers
+  *          with the LCD model attached and reports what each one costs on
+  *          the bus: I2C transactions, bytes, START conditions, bus time at
+  *          100 and 400 kHz and the CPU cycles the blocking driver spends
+  *          waiting (bus time plus lcd_busy_wait(), at BENCH_CPU_HZ).
+  *
+  *          Usage: lcdbench [-c] [-b baseline.csv]
+  *
+  *          -c prints CSV instead of a table, -b compares against a CSV
+  *          written by -c and exits with 1 when any call needs more
+  *          transactions or bytes than the baseline. Exits with 2 when the
+  *          LCD model saw a timing violation.
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include <stdio.h>
+#include <string.h>
+#include "host_regs.h"
+#include "lcd_sim.h"
+#include "lcd.h"
+
+
+/* The LCD model is a PCF8574 backpack on I2C1, there is no host model of
+   the bit banged bus */
+#if !( USE_LCD_I2C )
+#error "The host tools need USE_LCD_I2C set to 1 in lcd.h"
+#endif
+
+
+/* Core clock the wait cycles are reported at, SYSCLK of the target */
+#define BENCH_CPU_HZ                72000000ULL
+
+
+typedef struct
+{
+    const char *name;
+    void (*setup)(void);        /* not measured, may be NULL */
+    void (*run)(void);
+} benchCase_t;
+
+
+typedef struct
+{
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t starts;
+    uint32_t scl_clocks;
+    uint64_t delay_ns;          /* time spent in the delay loops */
+} benchResult_t;
+
+
+static void bench_measure(const benchCase_t *c, benchResult_t *res);
+static uint64_t bench_us(uint32_t clocks, uint32_t hz);
+static uint64_t bench_cycles(const benchResult_t *res, uint32_t hz);
+static int bench_compare(const char *path, const benchCase_t *cases, const benchResult_t *res, uint32_t count);
+
+static void setup_home(void);
+static void setup_row2(void);
+static void setup_display_on(void);
+static void setup_backlight_on(void);
+
+static void run_init(void);
+static void run_clear(void);
+static void run_goto_same(void);
+static void run_goto_other(void);
+static void run_print_1(void);
+static void run_print_8(void);
+static void run_print_16(void);
+static void run_print_40(void);
+static void run_display_same(void);
+static void run_display_other(void);
+static void run_shift(void);
+static void run_backlight(void);
+
+
+static const benchCase_t bench_cases[] =
+{
+    { "lcd_init",               NULL,               run_init },
+    { "lcd_clear",              NULL,               run_clear },
+    { "lcd_goto_xy same",       setup_home,         run_goto_same },
+    { "lcd_goto_xy",            setup_home,         run_goto_other },
+    { "lcd_print_string 1",     setup_row2,         run_print_1 },
+    { "lcd_print_string 8",     setup_row2,         run_print_8 },
+    { "lcd_print_string 16",    setup_row2,         run_print_16 },
+    { "lcd_print_string 40",    setup_row2,         run_print_40 },
+    { "lcd_display_ctrl same",  setup_display_on,   run_display_same },
+    { "lcd_display_ctrl",       setup_display_on,   run_display_other },
+    { "lcd_shift_display",      NULL,               run_shift },
+    { "lcd_backlight+flush",    setup_backlight_on, run_backlight },
+};
+
+#define BENCH_CASES                 ( sizeof(bench_cases) / sizeof(bench_cases[0]) )
+
+
+static lcdSim_t sim;
+
+
+
+int main(int argc, char *argv[])
+{
+    uint8_t csv = 0;
+    const char *baseline = NULL;
+    benchResult_t res[BENCH_CASES];
+
+    for(int i = 1; i < argc; i++)
+    {
+        if( strcmp(argv[i], "-c") == 0 )
+        {
+            csv = 1;
+        }
+        else if( (strcmp(argv[i], "-b") == 0) && ((i + 1) < argc) )
+        {
+            baseline = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr, "usage: lcdbench [-c] [-b baseline.csv]\n");
+            return 1;
+        }
+    }
+
+    host_regs_reset();
+    lcd_sim_init(&sim);
+    host_i2c_attach(LCD_SLAVE_ADDR, lcd_sim_i2c_write, lcd_sim_i2c_read, &sim);
+
+    for(uint32_t i = 0; i < BENCH_CASES; i++)
+    {
+        bench_measure(&bench_cases[i], &res[i]);
+    }
+
+    if( csv )
+    {
+        printf("call,transactions,bytes,starts,scl_clocks,us_100k,us_400k,wait_cycles_100k,wait_cycles_400k\n");
+    }
+    else
+    {
+        printf("%-24s %6s %6s %6s %9s %9s %11s %11s\n", "call", "trans", "bytes", "starts",
+               "us@100k", "us@400k", "wait@100k", "wait@400k");
+    }
+
+    for(uint32_t i = 0; i < BENCH_CASES; i++)
+    {
+        const benchResult_t *r = &res[i];
+
+        unsigned long long us100 = bench_us(r->scl_clocks, 100000);
+        unsigned long long us400 = bench_us(r->scl_clocks, 400000);
+        unsigned long long cyc100 = bench_cycles(r, 100000);
+        unsigned long long cyc400 = bench_cycles(r, 400000);
+
+        if( csv )
+        {
+            printf("%s,%u,%u,%u,%u,%llu,%llu,%llu,%llu\n", bench_cases[i].name, r->transactions,
+                   r->bytes, r->starts, r->scl_clocks, us100, us400, cyc100, cyc400);
+        }
+        else
+        {
+            printf("%-24s %6u %6u %6u %9llu %9llu %11llu %11llu\n", bench_cases[i].name,
+                   r->transactions, r->bytes, r->starts, us100, us400, cyc100, cyc400);
+        }
+    }
+
+    int status = 0;
+
+    if( baseline != NULL )
+    {
+        status = bench_compare(baseline, bench_cases, res, BENCH_CASES);
+    }
+
+    for(uint8_t k = 0; k < LCD_SIM_VIOL_COUNT; k++)
+    {
+        if( sim.violations[k] )
+        {
+            fprintf(stderr, "timing: %u %s violation(s), first at %llu ns\n", sim.violations[k],
+                    lcd_sim_violation_name((lcdSimViolation_t)k),
+                    (unsigned long long)sim.first_violation_ns[k]);
+            status = 2;
+        }
+    }
+
+    return status;
+}
+
+
+
+/**
+ * @brief    Static function to run the setup of a case, then measure its run
+ * @param    c: case
+ * @param    res: receives the cost of c->run
+ * @retval   none
+ */
+static void bench_measure(const benchCase_t *c, benchResult_t *res)
+{
+    if( c->setup != NULL )
+    {
+        c->setup();
+        host_i2c_sync();
+    }
+
+    hostI2cStats_t before = host_i2c_stats;
+    uint64_t clock_before = host_clock_ns;
+
+    c->run();
+    host_i2c_sync();
+
+    res->transactions = host_i2c_stats.transactions - before.transactions;
+    res->bytes = host_i2c_stats.bytes - before.bytes;
+    res->starts = host_i2c_stats.starts - before.starts;
+    res->scl_clocks = host_i2c_stats.scl_clocks - before.scl_clocks;
+    res->delay_ns = (host_clock_ns - clock_before) - (host_i2c_stats.bus_ns - before.bus_ns);
+}
+
+
+
+/**
+ * @brief    Static function to convert SCL periods to bus time
+ * @param    clocks: SCL periods
+ * @param    hz: SCL frequency
+ * @retval   time in us, rounded up
+ */
+static uint64_t bench_us(uint32_t clocks, uint32_t hz)
+{
+    return ((uint64_t)clocks * 1000000ULL + hz - 1) / hz;
+}
+
+
+
+/**
+ * @brief    Static function to estimate the CPU cycles a blocking call
+ *           spends waiting, the whole bus time plus its delay loops
+ * @param    res: measured case
+ * @param    hz: SCL frequency
+ * @retval   cycles at BENCH_CPU_HZ
+ */
+static uint64_t bench_cycles(const benchResult_t *res, uint32_t hz)
+{
+    uint64_t ns = res->delay_ns + ((uint64_t)res->scl_clocks * 1000000000ULL) / hz;
+
+    return (ns * BENCH_CPU_HZ) / 1000000000ULL;
+}
+
+
+
+/**
+ * @brief    Static function to compare the results with a CSV baseline
+ * @param    path: baseline written by lcdbench -c
+ * @param    cases: benchmark cases
+ * @param    res: results of cases
+ * @param    count: number of cases
+ * @retval   0 when nothing regressed, 1 otherwise
+ */
+static int bench_compare(const char *path, const benchCase_t *cases, const benchResult_t *res, uint32_t count)
+{
+    FILE *f = fopen(path, "r");
+    char line[256];
+    int status = 0;
+
+    if( f == NULL )
+    {
+        perror(path);
+        return 1;
+    }
+
+    while( fgets(line, sizeof(line), f) != NULL )
+    {
+        char *comma = strchr(line, ',');
+        unsigned trans, bytes;
+
+        if( (comma == NULL) || (sscanf(comma + 1, "%u,%u", &trans, &bytes) != 2) )
+        {
+            /* Header or garbage */
+            continue;
+        }
+        *comma = '\0';
+
+        for(uint32_t i = 0; i < count; i++)
+        {
+            if( strcmp(cases[i].name, line) != 0 )
+            {
+                continue;
+            }
+            if( (res[i].transactions > trans) || (res[i].bytes > bytes) )
+            {
+                fprintf(stderr, "regression: %s %u/%u transactions/bytes, baseline %u/%u\n",
+                        line, res[i].transactions, res[i].bytes, trans, bytes);
+                status = 1;
+            }
+        }
+    }
+
+    fclose(f);
+    return status;
+}
+
+
+
+/* Setup functions, run before a case and not measured */
+
+static void setup_home(void)
+{
+    lcd_goto_xy(1, 1);
+}
+
+static void setup_row2(void)
+{
+    lcd_goto_xy(2, 1);
+}
+
+static void setup_display_on(void)
+{
+    lcd_display_ctrl(1, 0, 0);
+}
+
+static void setup_backlight_on(void)
+{
+    lcd_backlight(1);
+    lcd_flush();
+}
+
+
+
+/* Measured calls */
+
+static void run_init(void)
+{
+    lcd_init();
+}
+
+static void run_clear(void)
+{
+    lcd_clear();
+}
+
+static void run_goto_same(void)
+{
+    lcd_goto_xy(1, 1);
+}
+
+static void run_goto_other(void)
+{
+    lcd_goto_xy(2, 5);
+}
+
+static void run_print_1(void)
+{
+    lcd_print_string("A");
+}
+
+static void run_print_8(void)
+{
+    lcd_print_string("ABCDEFGH");
+}
+
+static void run_print_16(void)
+{
+    lcd_print_string("ABCDEFGHIJKLMNOP");
+}
+
+static void run_print_40(void)
+{
+    lcd_print_string("ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789abcd");
+}
+
+static void run_display_same(void)
+{
+    lcd_display_ctrl(1, 0, 0);
+}
+
+static void run_display_other(void)
+{
+    lcd_display_ctrl(1, 1, 1);
+}
+
+static void run_shift(void)
+{
+    lcd_shift_display(1);
+}
+
+static void run_backlight(void)
+{
+    lcd_backlight(0);
+    lcd_flush();
+}
@@ -0,0 +1,629 @@
+/**
+  ******************************************************************************
+  * @file    check_main.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   lcdcheck: runs the modules drawing through the shadow
+  *          framebuffer against the LCD model: the console fed by the
+  *          USART1/DMA host registers, the marquee stepped by TIM2, the
+  *          frame decoder and the terminal. Prints one line per case.
+  *
+  *          Usage: lcdcheck
+  *
+  *          Exits with 1 when a case fails.
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include <stdio.h>
+#include <string.h>
+#include "host_regs.h"
+#include "lcd_sim.h"
+#include "lcd.h"
+#include "lcd_con.h"
+#include "lcd_frame.h"
+#include "lcd_marquee.h"
+#include "lcd_term.h"
+
+
+/* The LCD model is a PCF8574 backpack on I2C1, there is no host model of
+   the bit banged bus */
+#if !( USE_LCD_I2C )
+#error "The host tools need USE_LCD_I2C set to 1 in lcd.h"
+#endif
+
+
+/* One character at 115200 baud 8N1 */
+#define CHECK_CHAR_NS               86806ULL
+
+/* Main loop time around each lcd_con_process() */
+#define CHECK_LOOP_NS               2000ULL
+
+/* Characters of the console stream */
+#define CHECK_STREAM_LEN            20000UL
+
+/* Marquee steps in each direction */
+#define CHECK_MARQUEE_STEPS         300
+
+
+typedef struct
+{
+    const char *name;
+    const char *(*run)(void);   /* NULL on success, else what went wrong */
+} checkCase_t;
+
+
+static const char *check_lcd(void);
+static const char *check_screen(const char *row1, const char *row2);
+static void check_rx(const char *text);
+static void check_frame(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *out, size_t *out_len);
+static char check_marquee_cell(const char *text, int32_t pos, uint8_t col);
+
+static const char *run_con_lines(void);
+static const char *run_con_stream(void);
+static const char *run_entry_shift(void);
+static const char *run_marquee(void);
+static const char *run_frame_crc(void);
+static const char *run_frame_resync(void);
+static const char *run_term_cursor(void);
+
+
+static const checkCase_t check_cases[] =
+{
+    { "console lines",          run_con_lines },
+    { "console 20000 chars",    run_con_stream },
+    { "entry mode shift",       run_entry_shift },
+    { "marquee 300 each way",   run_marquee },
+    { "frame CRC",              run_frame_crc },
+    { "frame resync",           run_frame_resync },
+    { "term cursor modes",      run_term_cursor },
+};
+
+#define CHECK_CASES                 ( sizeof(check_cases) / sizeof(check_cases[0]) )
+
+
+static lcdSim_t sim;
+
+/* Figures a passing case reports after "ok" */
+static char check_note[64];
+
+void USART1_IRQHandler(void);
+void TIM2_IRQHandler(void);
+
+
+
+int main(void)
+{
+    int status = 0;
+
+    for(uint32_t i = 0; i < CHECK_CASES; i++)
+    {
+        check_note[0] = '\0';
+
+        const char *fail = check_cases[i].run();
+
+        printf("%-24s %s%s\n", check_cases[i].name, ( fail == NULL ) ? "ok" : fail, ( fail == NULL ) ? check_note : "");
+        if( fail != NULL )
+        {
+            status = 1;
+        }
+    }
+
+    return status;
+}
+
+
+
+/**
+ * @brief    Static function to reset the registers, attach the LCD model
+ *           at the address the driver uses and initialize it
+ * @param    none
+ * @retval   NULL when initialized, else what is wrong
+ */
+static const char *check_lcd(void)
+{
+    host_regs_reset();
+    lcd_sim_init(&sim);
+    host_i2c_attach(lcd_address(), lcd_sim_i2c_write, lcd_sim_i2c_read, &sim);
+
+    lcd_init();
+    host_i2c_sync();
+
+    if( (lcd_bus_status() != I2C_OK) || lcd_sim_violation_total(&sim) )
+    {
+        return "LCD not initialized";
+    }
+
+    return NULL;
+}
+
+
+
+/**
+ * @brief    Static function to compare the visible rows of the model,
+ *           trailing spaces may be left out
+ * @param    row1: expected first row
+ * @param    row2: expected second row
+ * @retval   NULL when both match, else which one differs
+ */
+static const char *check_screen(const char *row1, const char *row2)
+{
+    const char *expect[2] = { row1, row2 };
+    char row[LCD_SIM_COLS + 1];
+
+    host_i2c_sync();
+
+    for(uint8_t r = 0; r < 2; r++)
+    {
+        size_t len = strlen(expect[r]);
+
+        lcd_sim_screen(&sim, r, row);
+        if( strncmp(row, expect[r], len) != 0 )
+        {
+            return ( r == 0 ) ? "row 1 differs" : "row 2 differs";
+        }
+        for(size_t i = len; i < LCD_SIM_COLS; i++)
+        {
+            if( row[i] != ' ' )
+            {
+                return ( r == 0 ) ? "row 1 differs" : "row 2 differs";
+            }
+        }
+    }
+
+    if( lcd_sim_violation_total(&sim) )
+    {
+        return "timing violation";
+    }
+
+    return NULL;
+}
+
+
+
+/**
+ * @brief    Static function to receive text on USART1 followed by an
+ *           idle line
+ * @param    text: characters
+ * @retval   none
+ */
+static void check_rx(const char *text)
+{
+    host_usart1_rx((const uint8_t *)text, strlen(text));
+    USART1_IRQHandler();
+}
+
+
+
+/**
+ * @brief    Static function to encode a frame, CRC over type, length and
+ *           payload
+ * @param    type: frame type
+ * @param    payload: payload bytes
+ * @param    len: payload length
+ * @param    out: frame, len + 5 bytes
+ * @param    out_len: frame length
+ * @retval   none
+ */
+static void check_frame(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *out, size_t *out_len)
+{
+    uint16_t crc = 0xFFFF;
+    size_t n = 0;
+
+    out[n++] = LCD_FRAME_SOF;
+    out[n++] = type;
+    out[n++] = len;
+    crc = lcd_frame_crc(crc, type);
+    crc = lcd_frame_crc(crc, len);
+
+    for(uint8_t i = 0; i < len; i++)
+    {
+        out[n++] = payload[i];
+        crc = lcd_frame_crc(crc, payload[i]);
+    }
+
+    out[n++] = (uint8_t)(crc >> 8);
+    out[n++] = (uint8_t)(crc & 0xFF);
+    *out_len = n;
+}
+
+
+
+/**
+ * @brief    Static function to get the character a marquee shows in a
+ *           column, the text repeats after LCD_MARQUEE_GAP blanks
+ * @param    text: marquee text, NULL for a blank row
+ * @param    pos: steps to the left, negative to the right
+ * @param    col: column 0-15
+ * @retval   character
+ */
+static char check_marquee_cell(const char *text, int32_t pos, uint8_t col)
+{
+    if( text == NULL )
+    {
+        return ' ';
+    }
+
+    int32_t len = (int32_t)strlen(text);
+    int32_t period = len + LCD_MARQUEE_GAP;
+    int32_t i = (((pos + col) % period) + period) % period;
+
+    return ( i < len ) ? text[i] : ' ';
+}
+
+
+
+/**
+ * @brief    Line breaks, scrolling, wrapping at the right edge and form
+ *           feed of the text console
+ */
+static const char *run_con_lines(void)
+{
+    const char *fail = check_lcd();
+
+    if( fail != NULL )
+    {
+        return fail;
+    }
+
+    lcd_con_init();
+    (void)lcd_con_process();
+
+    check_rx("Hello\r\nworld");
+    (void)lcd_con_process();
+    if( (fail = check_screen("Hello", "world")) != NULL )
+    {
+        return fail;
+    }
+
+    check_rx("\r\nline3");
+    (void)lcd_con_process();
+    if( (fail = check_screen("world", "line3")) != NULL )
+    {
+        return fail;
+    }
+
+    check_rx("\f0123456789abcdefXY");
+    (void)lcd_con_process();
+
+    return check_screen("0123456789abcdef", "XY");
+}
+
+
+
+/**
+ * @brief    Stream CHECK_STREAM_LEN characters at 115200 baud without a
+ *           pause, the main loop only runs lcd_con_process(). Every
+ *           character has to be drawn and the backlog stay below the
+ *           receive buffer.
+ */
+static const char *run_con_stream(void)
+{
+    static const char line[] = "The quick brown fox jumps over the lazy dog 0123456789.\r\n";
+    const char *fail = check_lcd();
+    uint32_t sent = 0;
+    uint32_t drawn = 0;
+    uint32_t backlog = 0;
+    char tail[2][LCD_SIM_COLS + 1];
+
+    if( fail != NULL )
+    {
+        return fail;
+    }
+
+    lcd_con_init();
+    (void)lcd_con_process();
+
+    uint64_t t0 = host_clock_ns;
+
+    while( drawn < CHECK_STREAM_LEN )
+    {
+        uint64_t due = ((host_clock_ns - t0) / CHECK_CHAR_NS) + 1;
+
+        for( ; (sent < due) && (sent < CHECK_STREAM_LEN); sent++)
+        {
+            uint8_t c = (uint8_t)line[sent % (sizeof(line) - 1)];
+
+            host_usart1_rx(&c, 1);
+            host_usart1.SR = 0;
+        }
+        if( sent == CHECK_STREAM_LEN )
+        {
+            /* The line goes idle after the last character */
+            host_usart1.SR |= USART_SR_IDLE;
+            USART1_IRQHandler();
+        }
+
+        if( (sent - drawn) > backlog )
+        {
+            backlog = sent - drawn;
+        }
+
+        uint16_t n = lcd_con_process();
+
+        if( (n == 0) && (sent == CHECK_STREAM_LEN) )
+        {
+            break;
+        }
+        drawn += n;
+        host_clock_ns += CHECK_LOOP_NS;
+    }
+
+    snprintf(check_note, sizeof(check_note), ", backlog peak %lu of %u", (unsigned long)backlog, LCD_CON_RX_SIZE);
+
+    if( drawn != CHECK_STREAM_LEN )
+    {
+        return "characters lost";
+    }
+    if( backlog >= LCD_CON_RX_SIZE )
+    {
+        return "receive buffer overrun";
+    }
+
+    /* The last 16 and up to 16 characters of the unfinished line */
+    uint32_t col = CHECK_STREAM_LEN % (sizeof(line) - 1);
+    uint32_t last = ( col % LCD_SIM_COLS ) ? ( col % LCD_SIM_COLS ) : LCD_SIM_COLS;
+
+    memcpy(tail[0], &line[col - last - LCD_SIM_COLS], LCD_SIM_COLS);
+    tail[0][LCD_SIM_COLS] = '\0';
+    memcpy(tail[1], &line[col - last], last);
+    tail[1][last] = '\0';
+
+    return check_screen(tail[0], tail[1]);
+}
+
+
+
+/**
+ * @brief    Print with the entry mode shift on, to the left and to the
+ *           right, across the 40 column wrap and around a custom character
+ *           definition. lcd_shift() has to follow the display.
+ */
+static const char *run_entry_shift(void)
+{
+    static const uint8_t glyph[8] = { 0x04, 0x0E, 0x1F, 0x04, 0x04, 0x04, 0x04, 0x00 };
+    const char *fail = check_lcd();
+
+    if( fail != NULL )
+    {
+        return fail;
+    }
+
+    lcd_entry_mode(1, 1);
+    for(uint8_t i = 0; i < 45; i++)
+    {
+        lcd_print_string("L");
+    }
+    host_i2c_sync();
+    if( (lcd_shift() != sim.shift) || (sim.shift != 5) )
+    {
+        return "shift left differs";
+    }
+
+    lcd_cgram(0, glyph);
+    host_i2c_sync();
+    if( (lcd_shift() != sim.shift) || (sim.shift != 5) )
+    {
+        return "shift moved by lcd_cgram";
+    }
+
+    lcd_goto_xy(1, 1);
+    lcd_entry_mode(0, 1);
+    for(uint8_t i = 0; i < 50; i++)
+    {
+        lcd_print_string("R");
+    }
+    host_i2c_sync();
+    if( (lcd_shift() != sim.shift) || (sim.shift != 35) )
+    {
+        return "shift right differs";
+    }
+
+    if( (lcd_bus_status() != I2C_OK) || lcd_sim_violation_total(&sim) )
+    {
+        return "bus error";
+    }
+
+    return NULL;
+}
+
+
+
+/**
+ * @brief    CHECK_MARQUEE_STEPS TIM2 steps to the left with one row, then
+ *           to the right with both. Every step has to show the expected
+ *           window of the texts.
+ */
+static const char *run_marquee(void)
+{
+    static const char text1[] = "The quick brown fox jumps over the lazy dog, again and again!";
+    static const char text2[] = "<< second row ticker text, also quite long >>";
+    const char *fail = check_lcd();
+    uint32_t peak = 0;
+
+    if( fail != NULL )
+    {
+        return fail;
+    }
+
+    for(uint8_t dir = 0; dir < 2; dir++)
+    {
+        const char *rows[2] = { text1, dir ? text2 : NULL };
+
+        lcd_marquee_start(rows[0], rows[1], dir);
+        host_i2c_sync();
+
+        for(int32_t step = 1; step <= CHECK_MARQUEE_STEPS; step++)
+        {
+            char expect[2][LCD_SIM_COLS + 1];
+
+            host_i2c_stats.bytes = 0;
+            host_tim2.SR |= TIM_SR_UIF;
+            TIM2_IRQHandler();
+
+            if( lcd_marquee_process() != 1 )
+            {
+                lcd_marquee_stop();
+                return "step not drawn";
+            }
+            host_i2c_sync();
+
+            if( host_i2c_stats.bytes > peak )
+            {
+                peak = host_i2c_stats.bytes;
+            }
+
+            for(uint8_t r = 0; r < 2; r++)
+            {
+                for(uint8_t c = 0; c < LCD_SIM_COLS; c++)
+                {
+                    expect[r][c] = check_marquee_cell(rows[r], dir ? -step : step, c);
+                }
+                expect[r][LCD_SIM_COLS] = '\0';
+            }
+            if( (fail = check_screen(expect[0], expect[1])) != NULL )
+            {
+                lcd_marquee_stop();
+                return fail;
+            }
+        }
+    }
+
+    lcd_marquee_stop();
+    snprintf(check_note, sizeof(check_note), ", up to %lu bytes a step", (unsigned long)peak);
+
+    if( host_tim2.CR1 & TIM_CR1_CEN )
+    {
+        return "TIM2 left running";
+    }
+
+    return NULL;
+}
+
+
+
+/**
+ * @brief    CRC-16/CCITT-FALSE check value of "123456789"
+ */
+static const char *run_frame_crc(void)
+{
+    uint16_t crc = 0xFFFF;
+
+    for(const char *p = "123456789"; *p != '\0'; p++)
+    {
+        crc = lcd_frame_crc(crc, (uint8_t)*p);
+    }
+
+    return ( crc == 0x29B1 ) ? NULL : "check value differs";
+}
+
+
+
+/**
+ * @brief    A frame with a flipped payload bit and stray bytes holding a
+ *           start of frame are dropped, the next good frame is drawn
+ */
+static const char *run_frame_resync(void)
+{
+    static const uint8_t row1[] = "\x00Temp: 21.5C";
+    static const uint8_t row2[] = "\x10Hum:  40%";
+    static const uint8_t stray[] = { 0x00, LCD_FRAME_SOF, LCD_FRAME_CELLS };
+    static const uint8_t fix[] = { 0x00, 't' };
+    uint8_t buf[LCD_FRAME_MAX_PAYLOAD + 5];
+    size_t len;
+    const char *fail = check_lcd();
+
+    if( fail != NULL )
+    {
+        return fail;
+    }
+
+    lcd_frame_init();
+    (void)lcd_frame_flush();
+
+    check_frame(LCD_FRAME_CELLS, row1, sizeof(row1) - 1, buf, &len);
+    lcd_frame_write(buf, len);
+    check_frame(LCD_FRAME_CELLS, row2, sizeof(row2) - 1, buf, &len);
+    lcd_frame_write(buf, len);
+    (void)lcd_frame_flush();
+    if( (fail = check_screen("Temp: 21.5C", "Hum:  40%")) != NULL )
+    {
+        return fail;
+    }
+
+    check_frame(LCD_FRAME_CELLS, (const uint8_t *)"\x00XXXX", 5, buf, &len);
+    buf[4] ^= 0x01;
+    lcd_frame_write(buf, len);
+    lcd_frame_write(stray, sizeof(stray));
+    check_frame(LCD_FRAME_CELLS, fix, sizeof(fix), buf, &len);
+    lcd_frame_write(buf, len);
+    (void)lcd_frame_flush();
+
+    if( lcd_frame_errors() != 2 )
+    {
+        return "error count differs";
+    }
+
+    return check_screen("temp: 21.5C", "Hum:  40%");
+}
+
+
+
+/**
+ * @brief    Cursor on, blink on, cursor off: the blink goes with the
+ *           cursor, display control ends at 0x04
+ */
+static const char *run_term_cursor(void)
+{
+    static const char *const seq[] = { "\x1b[?25h", "\x1b[?12h", "\x1b[?25l" };
+    static const uint8_t display[] = { 0x06, 0x07, 0x04 };
+    const char *fail = check_lcd();
+
+    if( fail != NULL )
+    {
+        return fail;
+    }
+
+    lcd_term_init();
+    (void)lcd_term_flush();
+
+    for(uint8_t i = 0; i < 3; i++)
+    {
+        lcd_term_write((const uint8_t *)seq[i], strlen(seq[i]));
+        (void)lcd_term_flush();
+        host_i2c_sync();
+
+        if( sim.display != display[i] )
+        {
+            return "display control differs";
+        }
+    }
+
+    if( lcd_sim_violation_total(&sim) )
+    {
+        return "timing violation";
+    }
+
+    return NULL;
+}
@@ -0,0 +1,812 @@
+/**
+  ******************************************************************************
+  * @file    host_regs.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   In-memory peripheral registers for the host build of the drivers
+  *          and a scripted I2C1 responder behind them. See host_regs.h.
+  *
+  *          The driver writes DR as a byte, DR is parked at HOST_DR_EMPTY
+  *          after the responder consumed a write so the next write is seen
+  *          even when it repeats the previous value.
+  *
+  *          Reads are accounted as one byte per read address phase, which is
+  *          how the LCD driver reads the PCF8574.
+  *
+  *          host_i2c_remote() plays another master addressing I2C1 as
+  *          slave, the events reach the driver through its I2C1 interrupt
+  *          handlers.
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include <string.h>
+#include "host_regs.h"
+
+
+/* DR value meaning nothing was written since the last touch */
+#define HOST_DR_EMPTY               0xFFFF
+
+/* GPIOB IDR with SCL (PB6) and SDA (PB7) pulled up */
+#define HOST_GPIOB_IDLE             ( (1U << 6) | (1U << 7) )
+
+/* host_dma_addr() handles, an index into host_dma_mem[] */
+#define HOST_DMA_HANDLE             0xD0000000UL
+#define HOST_DMA_MAX_ADDR           4
+
+
+typedef enum
+{
+    HOST_BUS_IDLE = 0,
+    HOST_BUS_ADDR,              /* START sent, waiting for the address */
+    HOST_BUS_TX,                /* master transmitter */
+    HOST_BUS_RX,                /* master receiver */
+    HOST_BUS_HOLD,              /* NACK or error, waiting for STOP/START */
+    HOST_BUS_SLAVE              /* addressed by host_i2c_remote() */
+} hostBusState_t;
+
+
+typedef struct
+{
+    uint8_t addr;
+    hostI2cWrite_t write;
+    hostI2cRead_t read;
+    void *ctx;
+} hostI2cDevice_t;
+
+
+RCC_TypeDef host_rcc;
+GPIO_TypeDef host_gpioa;
+GPIO_TypeDef host_gpiob;
+CoreDebug_Type host_coredebug;
+uint32_t host_dwt_ctrl;
+ITM_Type host_itm;
+FILE *host_swo = NULL;
+uint16_t host_flash_page[512];
+USART_TypeDef host_usart1;
+DMA_Channel_TypeDef host_dma1_ch5;
+TIM_TypeDef host_tim2;
+
+hostI2cStats_t host_i2c_stats;
+hostI2cObserver_t host_i2c_observer = NULL;
+uint64_t host_clock_ns = 0;
+
+static I2C_TypeDef host_i2c1 = { .DR = HOST_DR_EMPTY };
+static FLASH_TypeDef host_flash = { .CR = FLASH_CR_LOCK };
+
+/* Memory behind the handles of host_dma_addr(), CNDTR of channel 5 as
+   programmed */
+static volatile void *host_dma_mem[HOST_DMA_MAX_ADDR];
+static uint8_t host_dma_count = 0;
+static uint16_t host_dma_reload = 0;
+
+static hostI2cDevice_t host_device[HOST_I2C_MAX_DEVICES];
+static uint8_t host_device_count = 0;
+static hostI2cDevice_t *host_target = NULL;
+static hostBusState_t host_bus = HOST_BUS_IDLE;
+
+/* Set by an SR1 read while ADDR is set, the next SR2 read clears ADDR */
+static uint8_t host_addr_sr1 = 0;
+
+/* Scripted fault */
+static uint16_t inject_flags = 0;
+static uint32_t inject_after = 0;
+
+
+static void host_i2c_event(hostI2cEvent_t event, uint8_t data);
+static void host_i2c_clocks(uint32_t clocks);
+static uint16_t host_i2c_fault(void);
+static hostI2cDevice_t *host_i2c_find(uint8_t addr);
+static uint8_t host_i2c_irq(uint16_t enable);
+
+/* I2C1 interrupt handlers of i2c.c */
+void I2C1_EV_IRQHandler(void);
+void I2C1_ER_IRQHandler(void);
+
+
+
+/**
+ * @brief    Return every register block to its reset value, detach all
+ *           devices, clear scripted faults and statistics
+ * @param    none
+ * @retval   none
+ */
+void host_regs_reset(void)
+{
+    memset(&host_rcc, 0, sizeof(host_rcc));
+    memset(&host_gpioa, 0, sizeof(host_gpioa));
+    memset(&host_gpiob, 0, sizeof(host_gpiob));
+    memset(&host_coredebug, 0, sizeof(host_coredebug));
+    host_dwt_ctrl = 0;
+    memset(&host_itm, 0, sizeof(host_itm));
+    memset(&host_i2c1, 0, sizeof(host_i2c1));
+    memset(&host_i2c_stats, 0, sizeof(host_i2c_stats));
+    host_clock_ns = 0;
+
+    host_i2c1.DR = HOST_DR_EMPTY;
+    host_gpiob.IDR = HOST_GPIOB_IDLE;
+
+    memset(&host_flash, 0, sizeof(host_flash));
+    host_flash.CR = FLASH_CR_LOCK;
+    memset(host_flash_page, 0xFF, sizeof(host_flash_page));
+
+    memset(&host_usart1, 0, sizeof(host_usart1));
+    memset(&host_dma1_ch5, 0, sizeof(host_dma1_ch5));
+    memset(&host_tim2, 0, sizeof(host_tim2));
+    host_dma_count = 0;
+    host_dma_reload = 0;
+
+    host_device_count = 0;
+    host_target = NULL;
+    host_bus = HOST_BUS_IDLE;
+    host_addr_sr1 = 0;
+    inject_flags = 0;
+    inject_after = 0;
+    host_i2c_observer = NULL;
+}
+
+
+
+/**
+ * @brief    Attach a device to the responder
+ * @param    addr: 7-bit address
+ * @param    write: called with each byte the master writes, may be NULL
+ * @param    read: called for each byte the master reads, may be NULL
+ * @param    ctx: passed back to write and read
+ * @retval   none
+ */
+void host_i2c_attach(uint8_t addr, hostI2cWrite_t write, hostI2cRead_t read, void *ctx)
+{
+    if( host_device_count < HOST_I2C_MAX_DEVICES )
+    {
+        hostI2cDevice_t *dev = &host_device[host_device_count++];
+        dev->addr = addr;
+        dev->write = write;
+        dev->read = read;
+        dev->ctx = ctx;
+    }
+}
+
+
+
+/**
+ * @brief    Script a fault: once after_bytes more bytes have been
+ *           transferred, the SR1 bits in sr1_flags (I2C_SR1_AF, ARLO
+ *           or BERR) are raised on the next byte
+ * @param    sr1_flags: SR1 error bits to raise
+ * @param    after_bytes: bytes to let through first
+ * @retval   none
+ */
+void host_i2c_inject(uint16_t sr1_flags, uint32_t after_bytes)
+{
+    inject_flags = sr1_flags;
+    inject_after = after_bytes;
+}
+
+
+
+/**
+ * @brief    Let the responder act on the last register write of the
+ *           driver, e.g. a STOP issued right before returning
+ * @param    none
+ * @retval   none
+ */
+void host_i2c_sync(void)
+{
+    host_i2c_stats.touches--;
+    (void)host_i2c1_touch();
+}
+
+
+
+/**
+ * @brief    Advance the virtual clock, called by the delay loop hooks
+ * @param    ns: time spent
+ * @retval   none
+ */
+void host_delay_ns(uint64_t ns)
+{
+    host_clock_ns += ns;
+}
+
+
+
+/**
+ * @brief    Write a word to an ITM stimulus port, appends a 4-byte
+ *           software source packet to host_swo
+ * @param    port: stimulus port
+ * @param    word: value written
+ * @retval   none
+ */
+void host_itm_put(uint8_t port, uint32_t word)
+{
+    if( host_swo != NULL )
+    {
+        /* Source packet header: port in bits 7-3, size 4 bytes */
+        fputc((port << 3) | 0x03, host_swo);
+        for(uint8_t i = 0; i < 4; i++)
+        {
+            fputc((word >> (8 * i)) & 0xFF, host_swo);
+        }
+    }
+}
+
+
+
+/**
+ * @brief    SCL frequency programmed in I2C1 CR2/CCR
+ * @param    none
+ * @retval   frequency in Hz, 0 when not configured
+ */
+uint32_t host_i2c_scl_hz(void)
+{
+    uint32_t pclk = (host_i2c1.CR2 & I2C_CR2_FREQ) * 1000000UL;
+    uint32_t ccr = host_i2c1.CCR & 0x0FFF;
+
+    if( (pclk == 0) || (ccr == 0) )
+    {
+        return 0;
+    }
+
+    if( !(host_i2c1.CCR & I2C_CCR_FS) )
+    {
+        return pclk / (2 * ccr);
+    }
+
+    return (host_i2c1.CCR & I2C_CCR_DUTY) ? (pclk / (25 * ccr)) : (pclk / (3 * ccr));
+}
+
+
+
+/**
+ * @brief    Called before every driver access to I2C1, applies what the
+ *           driver wrote since the previous access
+ * @param    none
+ * @retval   pointer to the I2C1 register block
+ */
+I2C_TypeDef *host_i2c1_touch(void)
+{
+    I2C_TypeDef *r = &host_i2c1;
+
+    host_i2c_stats.touches++;
+
+    /* Peripheral held in reset */
+    if( r->CR1 & I2C_CR1_SWRST )
+    {
+        r->SR1 = 0;
+        r->SR2 = 0;
+        r->DR = HOST_DR_EMPTY;
+        host_bus = HOST_BUS_IDLE;
+        host_target = NULL;
+        host_addr_sr1 = 0;
+        return r;
+    }
+
+    /* SCL is stretched after the address until ADDR is cleared, STOP,
+       START and the data wait for it */
+    if( r->SR1 & I2C_SR1_ADDR )
+    {
+        return r;
+    }
+
+    /* The slave events are raised by host_i2c_remote() */
+    if( host_bus == HOST_BUS_SLAVE )
+    {
+        return r;
+    }
+
+    if( r->CR1 & I2C_CR1_STOP )
+    {
+        r->CR1 &= ~I2C_CR1_STOP;
+
+        /* A master receiver sets STOP before the last byte arrives, the
+           byte stays readable */
+        uint16_t keep = ( host_bus == HOST_BUS_RX ) ? (r->SR1 & I2C_SR1_RXNE) : 0;
+
+        if( (host_bus == HOST_BUS_RX) && !keep )
+        {
+            uint8_t data = ( host_target->read != NULL ) ? host_target->read(host_target->ctx, host_clock_ns) : 0xFF;
+
+            host_i2c_event(HOST_I2C_READ, data);
+            r->DR = data;
+            keep = I2C_SR1_RXNE;
+        }
+
+        if( host_bus != HOST_BUS_IDLE )
+        {
+            host_i2c_clocks(1);
+            host_i2c_stats.stops++;
+            host_i2c_event(HOST_I2C_STOP, 0);
+        }
+        r->SR1 = keep;
+        r->SR2 = 0;
+        host_bus = HOST_BUS_IDLE;
+        host_target = NULL;
+    }
+
+    if( r->CR1 & I2C_CR1_START )
+    {
+        r->CR1 &= ~I2C_CR1_START;
+
+        if( r->CR1 & I2C_CR1_PE )
+        {
+            host_i2c_clocks(1);
+            host_i2c_stats.starts++;
+            host_i2c_event(HOST_I2C_START, 0);
+
+            r->SR1 = I2C_SR1_SB;
+            r->SR2 = I2C_SR2_MSL | I2C_SR2_BUSY;
+            r->DR = HOST_DR_EMPTY;
+            host_bus = HOST_BUS_ADDR;
+            host_target = NULL;
+        }
+    }
+
+    /* DR holds a received byte while RXNE is set */
+    if( (host_bus != HOST_BUS_RX) && !(r->SR1 & I2C_SR1_RXNE) && (r->DR != HOST_DR_EMPTY) )
+    {
+        uint8_t data = (uint8_t)r->DR;
+        r->DR = HOST_DR_EMPTY;
+
+        if( host_bus == HOST_BUS_ADDR )
+        {
+            uint16_t fault = host_i2c_fault();
+
+            r->SR1 &= ~I2C_SR1_SB;
+            host_i2c_clocks(9);
+            host_i2c_stats.bytes++;
+            host_i2c_event(HOST_I2C_ADDR, data);
+
+            host_target = host_i2c_find(data >> 1);
+
+            if( (host_target == NULL) || (fault & I2C_SR1_AF) )
+            {
+                host_i2c_stats.nacks++;
+                host_i2c_event(HOST_I2C_NACK, data);
+                r->SR1 |= I2C_SR1_AF;
+                host_bus = HOST_BUS_HOLD;
+            }
+            else if( fault )
+            {
+                r->SR1 |= fault;
+                host_bus = HOST_BUS_HOLD;
+            }
+            else
+            {
+                host_i2c_stats.transactions++;
+                r->SR1 |= I2C_SR1_ADDR;
+
+                if( data & 0x01 )
+                {
+                    host_bus = HOST_BUS_RX;
+                    r->SR2 &= ~I2C_SR2_TRA;
+                    host_i2c_clocks(9);
+                    host_i2c_stats.bytes++;
+                }
+                else
+                {
+                    host_bus = HOST_BUS_TX;
+                    r->SR2 |= I2C_SR2_TRA;
+                    r->SR1 |= I2C_SR1_TXE;
+                }
+            }
+        }
+        else if( host_bus == HOST_BUS_TX )
+        {
+            uint16_t fault = host_i2c_fault();
+
+            host_i2c_clocks(9);
+            host_i2c_stats.bytes++;
+
+            if( fault )
+            {
+                r->SR1 |= fault;
+                host_bus = HOST_BUS_HOLD;
+            }
+            else
+            {
+                host_i2c_event(HOST_I2C_WRITE, data);
+                if( host_target->write != NULL )
+                {
+                    host_target->write(host_target->ctx, data, host_clock_ns);
+                }
+                r->SR1 |= I2C_SR1_TXE | I2C_SR1_BTF;
+            }
+        }
+    }
+
+    if( (host_bus == HOST_BUS_RX) && !(r->SR1 & I2C_SR1_ADDR) )
+    {
+        uint8_t data = ( host_target->read != NULL ) ? host_target->read(host_target->ctx, host_clock_ns) : 0xFF;
+
+        if( (r->SR1 & I2C_SR1_RXNE) == 0 )
+        {
+            host_i2c_event(HOST_I2C_READ, data);
+        }
+        r->DR = data;
+        r->SR1 |= I2C_SR1_RXNE | I2C_SR1_BTF;
+    }
+
+    return r;
+}
+
+
+
+/**
+ * @brief    Read SR1 of I2C1 for the driver. Read while ADDR is set, it
+ *           is the first half of the ADDR clearing sequence.
+ * @param    none
+ * @retval   SR1
+ */
+uint16_t host_i2c1_sr1(void)
+{
+    I2C_TypeDef *r = host_i2c1_touch();
+
+    host_addr_sr1 = ( (r->SR1 & I2C_SR1_ADDR) != 0 );
+
+    return (uint16_t)r->SR1;
+}
+
+
+
+/**
+ * @brief    Read SR2 of I2C1 for the driver. Right after an SR1 read that
+ *           saw ADDR it clears ADDR, the transfer then goes on.
+ * @param    none
+ * @retval   SR2 before ADDR was cleared
+ */
+uint16_t host_i2c1_sr2(void)
+{
+    I2C_TypeDef *r = host_i2c1_touch();
+    uint16_t sr2 = (uint16_t)r->SR2;
+
+    if( host_addr_sr1 )
+    {
+        r->SR1 &= ~I2C_SR1_ADDR;
+        host_addr_sr1 = 0;
+    }
+
+    return sr2;
+}
+
+
+
+/**
+ * @brief    Play another master on the bus addressing I2C1 as slave: a
+ *           START, the address, len data bytes, then a STOP. I2C1
+ *           acknowledges an address matching OAR1 while ACK is set. Each
+ *           event is delivered through I2C1_EV_IRQHandler(), the NACK
+ *           ending a read through I2C1_ER_IRQHandler(), while CR2 enables
+ *           the interrupt. The transfer ends early when an event is not
+ *           served, as the remote master would time out.
+ * @param    addr: 7-bit address
+ * @param    read: 0 to write data, 1 to read into data
+ * @param    data: bytes to write, or receives the bytes read
+ * @param    len: number of data bytes
+ * @param    stop: 1 to end with a STOP, 0 for a repeated START next
+ * @retval   data bytes moved, 0 when the address was not acknowledged
+ */
+size_t host_i2c_remote(uint8_t addr, uint8_t read, uint8_t *data, size_t len, uint8_t stop)
+{
+    I2C_TypeDef *r = &host_i2c1;
+    size_t moved = 0;
+    uint8_t acked = (r->CR1 & I2C_CR1_PE) && (r->CR1 & I2C_CR1_ACK) && (((r->OAR1 >> 1) & 0x7F) == addr);
+
+    host_bus = HOST_BUS_SLAVE;
+    host_i2c_clocks(1);
+    host_i2c_stats.starts++;
+    host_i2c_event(HOST_I2C_START, 0);
+
+    host_i2c_clocks(9);
+    host_i2c_stats.bytes++;
+    host_i2c_event(HOST_I2C_ADDR, (uint8_t)((addr << 1) | (read ? 1 : 0)));
+
+    if( !acked )
+    {
+        host_i2c_stats.nacks++;
+        host_i2c_event(HOST_I2C_NACK, (uint8_t)((addr << 1) | (read ? 1 : 0)));
+        stop = 1;
+    }
+    else
+    {
+        /* EV1, SCL is held until the handler clears ADDR */
+        host_i2c_stats.transactions++;
+        r->SR1 |= I2C_SR1_ADDR;
+        r->SR2 = I2C_SR2_BUSY | ( read ? I2C_SR2_TRA : 0 );
+
+        if( host_i2c_irq(I2C_CR2_ITEVTEN) && !(r->SR1 & I2C_SR1_ADDR) )
+        {
+            for(moved = 0; moved < len; moved++)
+            {
+                if( read )
+                {
+                    /* EV3, the handler writes the next byte */
+                    r->DR = HOST_DR_EMPTY;
+                    r->SR1 |= I2C_SR1_TXE;
+                    if( !host_i2c_irq(I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN) || (r->DR == HOST_DR_EMPTY) )
+                    {
+                        break;
+                    }
+                    data[moved] = (uint8_t)r->DR;
+                    host_i2c_event(HOST_I2C_READ, data[moved]);
+                }
+                else
+                {
+                    /* EV2, the handler reads the byte */
+                    r->DR = data[moved];
+                    r->SR1 |= I2C_SR1_RXNE;
+                    if( !host_i2c_irq(I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN) )
+                    {
+                        break;
+                    }
+                    r->SR1 &= ~( I2C_SR1_RXNE );
+                    host_i2c_event(HOST_I2C_WRITE, data[moved]);
+                }
+                host_i2c_clocks(9);
+                host_i2c_stats.bytes++;
+            }
+        }
+
+        if( read )
+        {
+            /* EV3-2, the last byte is not acknowledged */
+            r->SR1 = ( r->SR1 & ~(I2C_SR1_TXE | I2C_SR1_ADDR) ) | I2C_SR1_AF;
+            (void)host_i2c_irq(I2C_CR2_ITERREN);
+        }
+        else if( stop && (moved == len) )
+        {
+            /* EV4 */
+            r->SR1 |= I2C_SR1_STOPF;
+            (void)host_i2c_irq(I2C_CR2_ITEVTEN);
+        }
+    }
+
+    if( stop || (moved < len) )
+    {
+        host_i2c_clocks(1);
+        host_i2c_stats.stops++;
+        host_i2c_event(HOST_I2C_STOP, 0);
+    }
+
+    r->SR1 = 0;
+    r->SR2 = 0;
+    r->DR = HOST_DR_EMPTY;
+    host_bus = HOST_BUS_IDLE;
+
+    return moved;
+}
+
+
+
+/**
+ * @brief    Called before every driver access to FLASH, unlocks after the
+ *           key sequence and carries out a started page erase
+ * @param    none
+ * @retval   pointer to the FLASH register block
+ */
+FLASH_TypeDef *host_flash_touch(void)
+{
+    if( host_flash.KEYR == 0xCDEF89ABUL )
+    {
+        host_flash.KEYR = 0;
+        host_flash.CR &= ~( FLASH_CR_LOCK );
+    }
+
+    if( (host_flash.CR & FLASH_CR_STRT) && (host_flash.CR & FLASH_CR_PER) && !(host_flash.CR & FLASH_CR_LOCK) )
+    {
+        memset(host_flash_page, 0xFF, sizeof(host_flash_page));
+        host_flash.CR &= ~( FLASH_CR_STRT );
+        host_flash.SR |= FLASH_SR_EOP;
+    }
+
+    return &host_flash;
+}
+
+
+
+/**
+ * @brief    Write flags to FLASH SR, which clears the flags written as 1
+ * @param    flags: SR flags to clear
+ * @retval   none
+ */
+void host_flash_sr_clear(uint32_t flags)
+{
+    host_flash_touch()->SR &= ~( flags );
+}
+
+
+
+/**
+ * @brief    Give memory used by DMA a 32-bit handle for CPAR/CMAR
+ * @param    p: memory
+ * @retval   handle
+ */
+uint32_t host_dma_addr(volatile void *p)
+{
+    for(uint8_t i = 0; i < host_dma_count; i++)
+    {
+        if( host_dma_mem[i] == p )
+        {
+            return HOST_DMA_HANDLE | i;
+        }
+    }
+    if( host_dma_count >= HOST_DMA_MAX_ADDR )
+    {
+        return 0;
+    }
+
+    host_dma_mem[host_dma_count] = p;
+    return HOST_DMA_HANDLE | host_dma_count++;
+}
+
+
+
+/**
+ * @brief    Receive characters on USART1 through DMA1 channel 5, which
+ *           writes them to CMAR and counts CNDTR down, reloading in
+ *           circular mode. IDLE is set after them, USART1_IRQHandler()
+ *           delivers it.
+ * @param    data: characters
+ * @param    len: number of characters
+ * @retval   none
+ */
+void host_usart1_rx(const uint8_t *data, size_t len)
+{
+    DMA_Channel_TypeDef *ch = &host_dma1_ch5;
+    uint32_t index = ch->CMAR & ~( HOST_DMA_HANDLE );
+
+    if( !(ch->CCR & DMA_CCR5_EN) || ((ch->CMAR & HOST_DMA_HANDLE) != HOST_DMA_HANDLE) ||
+        (index >= host_dma_count) )
+    {
+        return;
+    }
+
+    volatile uint8_t *mem = (volatile uint8_t *)host_dma_mem[index];
+
+    /* CNDTR is only written while the channel is disabled */
+    if( host_dma_reload == 0 )
+    {
+        host_dma_reload = (uint16_t)ch->CNDTR;
+    }
+
+    for(size_t i = 0; (i < len) && ch->CNDTR; i++)
+    {
+        mem[host_dma_reload - ch->CNDTR] = data[i];
+        ch->CNDTR--;
+
+        if( (ch->CNDTR == 0) && (ch->CCR & DMA_CCR5_CIRC) )
+        {
+            ch->CNDTR = host_dma_reload;
+        }
+    }
+
+    host_usart1.SR |= USART_SR_IDLE;
+}
+
+
+
+/**
+ * @brief    Static function to forward an event to the observer
+ * @param    event: bus event
+ * @param    data: byte associated with the event
+ * @retval   none
+ */
+static void host_i2c_event(hostI2cEvent_t event, uint8_t data)
+{
+    if( host_i2c_observer != NULL )
+    {
+        host_i2c_observer(event, data);
+    }
+}
+
+
+
+/**
+ * @brief    Static function to account SCL periods and bus time
+ * @param    clocks: number of SCL periods
+ * @retval   none
+ */
+static void host_i2c_clocks(uint32_t clocks)
+{
+    uint32_t hz = host_i2c_scl_hz();
+
+    host_i2c_stats.scl_clocks += clocks;
+
+    if( hz )
+    {
+        uint64_t ns = ((uint64_t)clocks * 1000000000ULL) / hz;
+        host_i2c_stats.bus_ns += ns;
+        host_clock_ns += ns;
+    }
+}
+
+
+
+/**
+ * @brief    Static function to fire the scripted fault when it is due
+ * @param    none
+ * @retval   SR1 error bits to raise on this byte, 0 for none
+ */
+static uint16_t host_i2c_fault(void)
+{
+    if( !inject_flags )
+    {
+        return 0;
+    }
+    if( inject_after )
+    {
+        inject_after--;
+        return 0;
+    }
+
+    uint16_t flags = inject_flags;
+    inject_flags = 0;
+    return flags;
+}
+
+
+
+/**
+ * @brief    Static function to deliver an I2C1 event while CR2 enables its
+ *           interrupt
+ * @param    enable: CR2 bits the event needs, I2C_CR2_ITERREN for an
+ *                   error event
+ * @retval   1 when the handler ran, 0 when the event was masked
+ */
+static uint8_t host_i2c_irq(uint16_t enable)
+{
+    if( (host_i2c1.CR2 & enable) != enable )
+    {
+        return 0;
+    }
+
+    if( enable & I2C_CR2_ITERREN )
+    {
+        I2C1_ER_IRQHandler();
+    }
+    else
+    {
+        I2C1_EV_IRQHandler();
+    }
+    return 1;
+}
+
+
+
+/**
+ * @brief    Static function to look up an attached device
+ * @param    addr: 7-bit address
+ * @retval   device, NULL when nothing is attached at addr
+ */
+static hostI2cDevice_t *host_i2c_find(uint8_t addr)
+{
+    for(uint8_t i = 0; i < host_device_count; i++)
+    {
+        if( host_device[i].addr == addr )
+        {
+            return &host_device[i];
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,525 @@
+/**
+  ******************************************************************************
+  * @file    lcd_sim.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   Host side behavioural model of a 1602 LCD (HD44780U) behind a
+  *          PCF8574 I/O expander. See lcd_sim.h for the wiring.
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include <string.h>
+#include "lcd_sim.h"
+
+
+static void lcd_sim_execute(lcdSim_t *sim, uint8_t rs, uint8_t value);
+static void lcd_sim_ac_step(lcdSim_t *sim);
+static void lcd_sim_shift(lcdSim_t *sim, uint8_t right);
+static uint8_t lcd_sim_read_value(const lcdSim_t *sim, uint8_t rs);
+static void lcd_sim_violation(lcdSim_t *sim, lcdSimViolation_t kind);
+
+
+static const char *const violation_name[LCD_SIM_VIOL_COUNT] =
+{
+    "busy", "PWEH", "tcycE", "hold", "tAS"
+};
+
+
+
+/**
+ * @brief    Put the model in its power-on state, 8-bit interface,
+ *           display off, DDRAM filled with spaces
+ * @param    sim: model to initialize
+ * @retval   none
+ */
+void lcd_sim_init(lcdSim_t *sim)
+{
+    memset(sim, 0, sizeof(*sim));
+    memset(sim->ddram, ' ', sizeof(sim->ddram));
+
+    /* Reset state of the internal reset circuit */
+    sim->entry = 0x02;
+    sim->function = 0x10;
+}
+
+
+
+/**
+ * @brief    Set the virtual time of the following writes, time never goes
+ *           backwards
+ * @param    sim: model
+ * @param    ns: time in ns
+ * @retval   none
+ */
+void lcd_sim_set_time(lcdSim_t *sim, uint64_t ns)
+{
+    if( ns > sim->now_ns )
+    {
+        sim->now_ns = ns;
+    }
+}
+
+
+
+/**
+ * @brief    Total number of timing violations seen so far
+ * @param    sim: model
+ * @retval   sum of sim->violations
+ */
+uint32_t lcd_sim_violation_total(const lcdSim_t *sim)
+{
+    uint32_t total = 0;
+
+    for(uint8_t i = 0; i < LCD_SIM_VIOL_COUNT; i++)
+    {
+        total += sim->violations[i];
+    }
+    return total;
+}
+
+
+
+/**
+ * @brief    Short name of a timing violation kind
+ * @param    kind: violation kind
+ * @retval   name
+ */
+const char *lcd_sim_violation_name(lcdSimViolation_t kind)
+{
+    return ( kind < LCD_SIM_VIOL_COUNT ) ? violation_name[kind] : "?";
+}
+
+
+
+/**
+ * @brief    Write a byte to the PCF8574 output latch
+ * @param    sim: model
+ * @param    port: new value of P7-P0
+ * @retval   none
+ */
+void lcd_sim_write(lcdSim_t *sim, uint8_t port)
+{
+    uint8_t prev = sim->port;
+    uint8_t changed = prev ^ port;
+
+    sim->port = port;
+    sim->port_writes++;
+
+    /* EN rising edge */
+    if( !(prev & LCD_SIM_EN) && (port & LCD_SIM_EN) )
+    {
+        if( sim->en_seen && ((sim->now_ns - sim->en_rise_ns) < LCD_SIM_T_CYCE) )
+        {
+            lcd_sim_violation(sim, LCD_SIM_VIOL_CYCE);
+        }
+        if( sim->strict && (changed & (LCD_SIM_RS | LCD_SIM_RW)) )
+        {
+            lcd_sim_violation(sim, LCD_SIM_VIOL_TAS);
+        }
+        sim->en_rise_ns = sim->now_ns;
+        sim->en_seen = 1;
+    }
+
+    /* EN falling edge */
+    if( (prev & LCD_SIM_EN) && !(port & LCD_SIM_EN) )
+    {
+        if( (sim->now_ns - sim->en_rise_ns) < LCD_SIM_T_PWEH )
+        {
+            lcd_sim_violation(sim, LCD_SIM_VIOL_PWEH);
+        }
+        if( changed & (LCD_SIM_RS | LCD_SIM_RW | 0xF0) )
+        {
+            lcd_sim_violation(sim, LCD_SIM_VIOL_HOLD);
+        }
+        if( !(prev & LCD_SIM_RW) && (sim->now_ns < sim->busy_until_ns) )
+        {
+            lcd_sim_violation(sim, LCD_SIM_VIOL_BUSY);
+        }
+    }
+
+    /* EN rising edge of a read, the LCD starts driving D7-D4 */
+    if( !(prev & LCD_SIM_EN) && (port & LCD_SIM_EN) && (port & LCD_SIM_RW) )
+    {
+        if( !sim->nibble_pending )
+        {
+            sim->read_latch = lcd_sim_read_value(sim, port & LCD_SIM_RS);
+        }
+        return;
+    }
+
+    /* Everything else happens on the EN falling edge */
+    if( !(prev & LCD_SIM_EN) || (port & LCD_SIM_EN) )
+    {
+        return;
+    }
+
+    uint8_t rs = prev & LCD_SIM_RS;
+
+    if( prev & LCD_SIM_RW )
+    {
+        if( sim->four_bit && !sim->nibble_pending )
+        {
+            sim->nibble_pending = 1;
+            return;
+        }
+        sim->nibble_pending = 0;
+
+        /* Data reads advance the address counter like writes */
+        if( rs )
+        {
+            sim->data_reads++;
+            lcd_sim_ac_step(sim);
+        }
+        return;
+    }
+
+    /* Nibble on D7-D4 while EN was high */
+    uint8_t nibble = prev >> 4;
+
+    if( !sim->four_bit )
+    {
+        /* D3-D0 are not connected, only the upper half is seen */
+        lcd_sim_execute(sim, rs, nibble << 4);
+    }
+    else if( !sim->nibble_pending )
+    {
+        sim->nibble_hi = nibble;
+        sim->nibble_pending = 1;
+    }
+    else
+    {
+        sim->nibble_pending = 0;
+        lcd_sim_execute(sim, rs, (sim->nibble_hi << 4) | nibble);
+    }
+}
+
+
+
+/**
+ * @brief    Read a byte from the PCF8574. D7-D4 are driven by the LCD while
+ *           RW and EN are high and read as the latch value otherwise.
+ * @param    sim: model
+ * @retval   value of P7-P0
+ */
+uint8_t lcd_sim_read(lcdSim_t *sim)
+{
+    uint8_t value = sim->port;
+
+    sim->port_reads++;
+
+    if( (sim->port & LCD_SIM_RW) && (sim->port & LCD_SIM_EN) )
+    {
+        uint8_t nibble = ( sim->four_bit && sim->nibble_pending ) ?
+                         ( sim->read_latch & 0x0F ) : ( sim->read_latch >> 4 );
+
+        /* Quasi-bidirectional port, a pin latched low always reads low */
+        value = (sim->port & 0x0F) | ((nibble << 4) & sim->port & 0xF0);
+    }
+
+    return value;
+}
+
+
+
+/**
+ * @brief    Copy the visible characters of a row, taking the display shift
+ *           and the display on/off control into account
+ * @param    sim: model
+ * @param    row: 0 or 1
+ * @param    buf: receives LCD_SIM_COLS characters and a terminating null
+ * @retval   none
+ */
+void lcd_sim_screen(const lcdSim_t *sim, uint8_t row, char *buf)
+{
+    uint8_t base = row ? 0x40 : 0x00;
+
+    for(uint8_t c = 0; c < LCD_SIM_COLS; c++)
+    {
+        if( sim->display & 0x04 )
+        {
+            buf[c] = sim->ddram[base + ((sim->shift + c) % LCD_SIM_LINE_LEN)];
+        }
+        else
+        {
+            buf[c] = ' ';
+        }
+    }
+    buf[LCD_SIM_COLS] = '\0';
+}
+
+
+
+/**
+ * @brief    Return the backlight state driven by P3
+ * @param    sim: model
+ * @retval   1 when on, 0 when off
+ */
+uint8_t lcd_sim_backlight(const lcdSim_t *sim)
+{
+    return (sim->port & LCD_SIM_BL) ? 1 : 0;
+}
+
+
+
+/**
+ * @brief    host_regs.h device write adapter, ctx is the lcdSim_t
+ * @param    ctx: model
+ * @param    data: byte written to the PCF8574
+ * @param    t_ns: time the PCF8574 outputs change
+ * @retval   none
+ */
+void lcd_sim_i2c_write(void *ctx, uint8_t data, uint64_t t_ns)
+{
+    lcd_sim_set_time((lcdSim_t *)ctx, t_ns);
+    lcd_sim_write((lcdSim_t *)ctx, data);
+}
+
+
+
+/**
+ * @brief    host_regs.h device read adapter, ctx is the lcdSim_t
+ * @param    ctx: model
+ * @param    t_ns: time the PCF8574 inputs are sampled
+ * @retval   byte read from the PCF8574
+ */
+uint8_t lcd_sim_i2c_read(void *ctx, uint64_t t_ns)
+{
+    lcd_sim_set_time((lcdSim_t *)ctx, t_ns);
+    return lcd_sim_read((lcdSim_t *)ctx);
+}
+
+
+
+/**
+ * @brief    Static function to execute a complete instruction or data write
+ * @param    sim: model
+ * @param    rs: data (1) or instruction (0)
+ * @param    value: 8-bit instruction or character
+ * @retval   none
+ */
+static void lcd_sim_execute(lcdSim_t *sim, uint8_t rs, uint8_t value)
+{
+    if( rs )
+    {
+        sim->data_writes++;
+        sim->busy_until_ns = sim->now_ns + LCD_SIM_T_DATA;
+
+        if( sim->ac_cgram )
+        {
+            sim->cgram[sim->ac & 0x3F] = value;
+        }
+        else
+        {
+            sim->ddram[sim->ac & 0x7F] = value;
+        }
+        lcd_sim_ac_step(sim);
+
+        /* Entry mode S, the display follows the cursor. CGRAM writes do
+           not shift it. */
+        if( (sim->entry & 0x01) && !sim->ac_cgram )
+        {
+            lcd_sim_shift(sim, !(sim->entry & 0x02));
+        }
+        return;
+    }
+
+    if( value == 0x00 )
+    {
+        /* Not an instruction */
+        return;
+    }
+    sim->instructions++;
+    sim->busy_until_ns = sim->now_ns + LCD_SIM_T_EXEC;
+
+    if( value & 0x80 )
+    {
+        /* Set DDRAM address */
+        sim->ac = value & 0x7F;
+        sim->ac_cgram = 0;
+    }
+    else if( value & 0x40 )
+    {
+        /* Set CGRAM address */
+        sim->ac = value & 0x3F;
+        sim->ac_cgram = 1;
+    }
+    else if( value & 0x20 )
+    {
+        /* Function set, the first two of the initialization by
+           instruction sequence take longer */
+        if( !sim->four_bit && (value & 0x10) && (sim->init_sets < 2) )
+        {
+            sim->busy_until_ns = sim->now_ns +
+                                 ( (sim->init_sets == 0) ? LCD_SIM_T_INIT1 : LCD_SIM_T_INIT2 );
+            sim->init_sets++;
+        }
+        sim->function = value & 0x1C;
+        sim->four_bit = !(value & 0x10);
+        sim->nibble_pending = 0;
+    }
+    else if( value & 0x10 )
+    {
+        /* Cursor or display shift */
+        if( value & 0x08 )
+        {
+            lcd_sim_shift(sim, value & 0x04);
+        }
+        else
+        {
+            uint8_t entry = sim->entry;
+            sim->entry = (value & 0x04) ? 0x02 : 0x00;
+            lcd_sim_ac_step(sim);
+            sim->entry = entry;
+        }
+    }
+    else if( value & 0x08 )
+    {
+        /* Display on/off control */
+        sim->display = value & 0x07;
+    }
+    else if( value & 0x04 )
+    {
+        /* Entry mode set */
+        sim->entry = value & 0x03;
+    }
+    else if( value & 0x02 )
+    {
+        /* Return home */
+        sim->busy_until_ns = sim->now_ns + LCD_SIM_T_CLEAR;
+        sim->ac = 0x00;
+        sim->ac_cgram = 0;
+        sim->shift = 0;
+    }
+    else
+    {
+        /* Clear display */
+        sim->busy_until_ns = sim->now_ns + LCD_SIM_T_CLEAR;
+        memset(sim->ddram, ' ', sizeof(sim->ddram));
+        sim->ac = 0x00;
+        sim->ac_cgram = 0;
+        sim->shift = 0;
+        sim->entry |= 0x02;
+    }
+}
+
+
+
+/**
+ * @brief    Static function to move the address counter one step in the
+ *           entry mode direction, wrapping between the two DDRAM lines
+ * @param    sim: model
+ * @retval   none
+ */
+static void lcd_sim_ac_step(lcdSim_t *sim)
+{
+    if( sim->ac_cgram )
+    {
+        sim->ac = (sim->entry & 0x02) ? ((sim->ac + 1) & 0x3F) : ((sim->ac - 1) & 0x3F);
+        return;
+    }
+
+    if( sim->entry & 0x02 )
+    {
+        sim->ac = (sim->ac + 1) & 0x7F;
+
+        if( sim->ac == 0x28 )
+        {
+            sim->ac = 0x40;
+        }
+        else if( sim->ac == 0x68 )
+        {
+            sim->ac = 0x00;
+        }
+    }
+    else
+    {
+        if( sim->ac == 0x00 )
+        {
+            sim->ac = 0x67;
+        }
+        else if( sim->ac == 0x40 )
+        {
+            sim->ac = 0x27;
+        }
+        else
+        {
+            sim->ac = (sim->ac - 1) & 0x7F;
+        }
+    }
+}
+
+
+
+/**
+ * @brief    Static function to shift the display one column
+ * @param    sim: model
+ * @param    right: contents move to the right (1) or to the left (0)
+ * @retval   none
+ */
+static void lcd_sim_shift(lcdSim_t *sim, uint8_t right)
+{
+    if( right )
+    {
+        sim->shift = (sim->shift + LCD_SIM_LINE_LEN - 1) % LCD_SIM_LINE_LEN;
+    }
+    else
+    {
+        sim->shift = (sim->shift + 1) % LCD_SIM_LINE_LEN;
+    }
+}
+
+
+
+/**
+ * @brief    Static function to fetch the byte returned by a read
+ * @param    sim: model
+ * @param    rs: data (1) or busy flag and address (0)
+ * @retval   byte the LCD puts on the bus
+ */
+static uint8_t lcd_sim_read_value(const lcdSim_t *sim, uint8_t rs)
+{
+    if( !rs )
+    {
+        return ( (sim->now_ns < sim->busy_until_ns) ? 0x80 : 0x00 ) | (sim->ac & 0x7F);
+    }
+
+    return sim->ac_cgram ? sim->cgram[sim->ac & 0x3F] : sim->ddram[sim->ac & 0x7F];
+}
+
+
+
+/**
+ * @brief    Static function to record a timing violation
+ * @param    sim: model
+ * @param    kind: violation kind
+ * @retval   none
+ */
+static void lcd_sim_violation(lcdSim_t *sim, lcdSimViolation_t kind)
+{
+    if( sim->violations[kind]++ == 0 )
+    {
+        sim->first_violation_ns[kind] = sim->now_ns;
+    }
+}
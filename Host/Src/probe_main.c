@@ -0,0 +1,861 @@
+/**
+  ******************************************************************************
+  * @file    probe_main.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   i2cprobe: runs the address-only probe of i2c_transfer(),
+  *          i2c_scan() and lcd_discover() against the host registers,
+  *          which keep ADDR set and SCL held until SR1 then SR2 are read,
+  *          like I2C1 does. Also checks the LCD shadow state after NACKs,
+  *          the stored calibration, and the interrupt slave with lcd_cop
+  *          driven by a remote master. Prints one line per case.
+  *
+  *          Usage: i2cprobe
+  *
+  *          Exits with 1 when a case fails.
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include <stdio.h>
+#include <string.h>
+#include "host_regs.h"
+#include "lcd_sim.h"
+#include "lcd.h"
+#include "lcd_cal.h"
+#include "lcd_cop.h"
+#include "i2c.h"
+
+
+/* The LCD model is a PCF8574 backpack on I2C1, there is no host model of
+   the bit banged bus */
+#if !( USE_LCD_I2C )
+#error "The host tools need USE_LCD_I2C set to 1 in lcd.h"
+#endif
+
+
+typedef struct
+{
+    const char *name;
+    const char *(*run)(void);   /* NULL on success, else what went wrong */
+} probeCase_t;
+
+
+static void probe_setup(const uint8_t *addr, uint8_t count);
+static const char *probe_released(uint32_t stops);
+static const char *probe_lcd(void);
+static void probe_received(const uint8_t *buf, uint8_t len, uint8_t dropped);
+static const uint8_t *probe_transmit(uint8_t *len);
+
+static const char *run_present(void);
+static const char *run_absent(void);
+static const char *run_nostop(void);
+static const char *run_scan(void);
+static const char *run_discover(void);
+static const char *run_nack_goto(void);
+static const char *run_nack_ctrl(void);
+static const char *run_nack_shift(void);
+static const char *run_nack_home(void);
+static const char *run_cal_store(void);
+static const char *run_cal_full(void);
+static const char *run_slave_write(void);
+static const char *run_slave_overrun(void);
+static const char *run_slave_read(void);
+static const char *run_slave_master(void);
+#if ( USE_LCD_COP_IRQ )
+static const char *run_cop_render(void);
+#endif
+
+
+static const probeCase_t probe_cases[] =
+{
+    { "probe present",          run_present },
+    { "probe absent",           run_absent },
+    { "probe NOSTOP+write",     run_nostop },
+    { "i2c_scan 3 devices",     run_scan },
+    { "lcd_discover 3 displays", run_discover },
+    { "NACK lcd_goto_xy",       run_nack_goto },
+    { "NACK lcd_display_ctrl",  run_nack_ctrl },
+    { "NACK lcd_shift_display", run_nack_shift },
+    { "NACK lcd_home",          run_nack_home },
+    { "lcd_calibrate store",    run_cal_store },
+    { "lcd_calibrate full page", run_cal_full },
+    { "slave IRQ write",        run_slave_write },
+    { "slave IRQ overrun",      run_slave_overrun },
+    { "slave IRQ write+read",   run_slave_read },
+    { "slave IRQ then master",  run_slave_master },
+#if ( USE_LCD_COP_IRQ )
+    { "lcd_cop render",         run_cop_render },
+#endif
+};
+
+#define PROBE_CASES                 ( sizeof(probe_cases) / sizeof(probe_cases[0]) )
+
+#define PROBE_MAX_DEVICES           4
+
+
+static lcdSim_t sim[PROBE_MAX_DEVICES];
+
+/* Interrupt slave served by probe_received() and probe_transmit() */
+static const i2cSlaveHooks_t probe_hooks = { probe_received, probe_transmit };
+static const uint8_t slave_tx[] = { 0xA0, 0xA1, 0xA2, 0xA3 };
+static uint8_t slave_rx[I2C_SLAVE_RX_SIZE];
+static uint8_t slave_rx_len;
+static uint8_t slave_dropped;
+static uint8_t slave_writes;
+
+
+
+int main(void)
+{
+    int status = 0;
+
+    for(uint32_t i = 0; i < PROBE_CASES; i++)
+    {
+        const char *fail = probe_cases[i].run();
+
+        printf("%-24s %s\n", probe_cases[i].name, ( fail == NULL ) ? "ok" : fail);
+        if( fail != NULL )
+        {
+            status = 1;
+        }
+    }
+
+    return status;
+}
+
+
+
+/**
+ * @brief    Static function to reset the registers and attach an LCD model
+ *           at each address
+ * @param    addr: 7-bit addresses
+ * @param    count: number of addresses, at most PROBE_MAX_DEVICES
+ * @retval   none
+ */
+static void probe_setup(const uint8_t *addr, uint8_t count)
+{
+    /* Interrupt slave of a previous case */
+    i2c_slave_irq_stop();
+
+    host_regs_reset();
+
+    for(uint8_t i = 0; (i < count) && (i < PROBE_MAX_DEVICES); i++)
+    {
+        lcd_sim_init(&sim[i]);
+        host_i2c_attach(addr[i], lcd_sim_i2c_write, lcd_sim_i2c_read, &sim[i]);
+    }
+
+    i2c_init();
+}
+
+
+
+/**
+ * @brief    Static function to check that the last transfer left the bus
+ *           released: ADDR cleared and the STOP sent
+ * @param    stops: STOP conditions expected since probe_setup()
+ * @retval   NULL when released, else what is wrong
+ */
+static const char *probe_released(uint32_t stops)
+{
+    host_i2c_sync();
+
+    if( I2C1->SR1 & I2C_SR1_ADDR )
+    {
+        return "ADDR left set, SCL held";
+    }
+    if( I2C1->CR1 & I2C_CR1_STOP )
+    {
+        return "STOP not sent";
+    }
+    if( host_i2c_stats.stops != stops )
+    {
+        return "STOP count";
+    }
+
+    return NULL;
+}
+
+
+
+/**
+ * @brief    Static function to attach one LCD model at the address the
+ *           driver currently uses and initialize it
+ * @param    none
+ * @retval   NULL when initialized, else what is wrong
+ */
+static const char *probe_lcd(void)
+{
+    uint8_t addr = lcd_address();
+
+    probe_setup(&addr, 1);
+    lcd_init();
+    host_i2c_sync();
+
+    if( (lcd_bus_status() != I2C_OK) || lcd_sim_violation_total(&sim[0]) )
+    {
+        return "LCD not initialized";
+    }
+
+    return NULL;
+}
+
+
+
+/**
+ * @brief    Static function, received hook of the interrupt slave
+ * @param    buf: bytes received
+ * @param    len: number of bytes
+ * @param    dropped: bytes that did not fit
+ * @retval   none
+ */
+static void probe_received(const uint8_t *buf, uint8_t len, uint8_t dropped)
+{
+    memcpy(slave_rx, buf, len);
+    slave_rx_len = len;
+    slave_dropped = dropped;
+    slave_writes++;
+}
+
+
+
+/**
+ * @brief    Static function, transmit hook of the interrupt slave
+ * @param    len: receives the number of bytes
+ * @retval   bytes to send
+ */
+static const uint8_t *probe_transmit(uint8_t *len)
+{
+    *len = sizeof(slave_tx);
+    return slave_tx;
+}
+
+
+
+/**
+ * @brief    Probe a device that answers, then write to it
+ */
+static const char *run_present(void)
+{
+    static const uint8_t addr[] = { 0x27 };
+    uint8_t data = 0x08;
+
+    probe_setup(addr, 1);
+
+    if( i2c_transfer(I2C_BUS_1, 0x27, NULL, 0, NULL, 0, 0) != I2C_OK )
+    {
+        return "probe not acknowledged";
+    }
+
+    const char *fail = probe_released(1);
+
+    if( fail != NULL )
+    {
+        return fail;
+    }
+    if( i2c_transfer(I2C_BUS_1, 0x27, &data, 1, NULL, 0, 0) != I2C_OK )
+    {
+        return "write after the probe failed";
+    }
+
+    return probe_released(2);
+}
+
+
+
+/**
+ * @brief    Probe an address nobody answers, then a device that does
+ */
+static const char *run_absent(void)
+{
+    static const uint8_t addr[] = { 0x27 };
+
+    probe_setup(addr, 1);
+
+    if( i2c_transfer(I2C_BUS_1, 0x26, NULL, 0, NULL, 0, 0) != I2C_ERR_NACK )
+    {
+        return "absent device not reported as NACK";
+    }
+
+    const char *fail = probe_released(1);
+
+    if( fail != NULL )
+    {
+        return fail;
+    }
+    if( i2c_transfer(I2C_BUS_1, 0x27, NULL, 0, NULL, 0, 0) != I2C_OK )
+    {
+        return "probe after a NACK failed";
+    }
+
+    return probe_released(2);
+}
+
+
+
+/**
+ * @brief    Probe keeping the bus, then write with a repeated START
+ */
+static const char *run_nostop(void)
+{
+    static const uint8_t addr[] = { 0x27 };
+    uint8_t data = 0x08;
+
+    probe_setup(addr, 1);
+
+    if( i2c_transfer(I2C_BUS_1, 0x27, NULL, 0, NULL, 0, I2C_XFER_NOSTOP) != I2C_OK )
+    {
+        return "probe not acknowledged";
+    }
+    if( i2c_transfer(I2C_BUS_1, 0x27, &data, 1, NULL, 0, 0) != I2C_OK )
+    {
+        return "write after a repeated START failed";
+    }
+    if( host_i2c_stats.starts != 2 )
+    {
+        return "no repeated START";
+    }
+
+    return probe_released(1);
+}
+
+
+
+/**
+ * @brief    Scan with three devices answering among absent addresses
+ */
+static const char *run_scan(void)
+{
+    static const uint8_t addr[] = { 0x20, 0x27, 0x3F };
+    uint8_t found[PROBE_MAX_DEVICES];
+
+    probe_setup(addr, 3);
+
+    if( i2c_scan(0x08, 0x77, found, PROBE_MAX_DEVICES) != 3 )
+    {
+        return "wrong number of devices";
+    }
+    if( memcmp(found, addr, sizeof(addr)) != 0 )
+    {
+        return "wrong addresses";
+    }
+
+    return probe_released(0x77 - 0x08 + 1);
+}
+
+
+
+/**
+ * @brief    Discover three backpacks, then print on each display
+ */
+static const char *run_discover(void)
+{
+    static const uint8_t addr[] = { 0x21, 0x27, 0x38 };
+    static const char *text[] = { "first", "second", "third" };
+    char row[LCD_SIM_COLS + 1];
+
+    probe_setup(addr, 3);
+
+    if( lcd_discover() != 3 )
+    {
+        return "wrong number of displays";
+    }
+
+    for(uint8_t i = 0; i < 3; i++)
+    {
+        if( !lcd_select(i) || (lcd_address() != addr[i]) )
+        {
+            return "wrong display order";
+        }
+        lcd_write(1, 1, (const uint8_t *)text[i], strlen(text[i]));
+    }
+    (void)lcd_select(0);
+    host_i2c_sync();
+
+    for(uint8_t i = 0; i < 3; i++)
+    {
+        lcd_sim_screen(&sim[i], 0, row);
+        if( (strncmp(row, text[i], strlen(text[i])) != 0) || lcd_sim_violation_total(&sim[i]) )
+        {
+            return "display not initialized";
+        }
+    }
+
+    return NULL;
+}
+
+
+
+/**
+ * @brief    A cursor move lost to a NACK is sent again by the next
+ *           lcd_goto_xy() to the same position
+ */
+static const char *run_nack_goto(void)
+{
+    const char *fail = probe_lcd();
+    char row[LCD_SIM_COLS + 1];
+
+    if( fail != NULL )
+    {
+        return fail;
+    }
+
+    lcd_write(1, 1, (const uint8_t *)"ABCD", 4);
+
+    /* NACK on the second nibble of the set DDRAM address */
+    host_i2c_inject(I2C_SR1_AF, 2);
+    lcd_goto_xy(1, 3);
+    if( lcd_bus_status() != I2C_ERR_NACK )
+    {
+        return "NACK not reported";
+    }
+
+    lcd_goto_xy(1, 3);
+    lcd_print_string("E");
+    host_i2c_sync();
+
+    lcd_sim_screen(&sim[0], 0, row);
+    if( (strncmp(row, "ABED", 4) != 0) || (sim[0].ac != 0x03) )
+    {
+        return "cursor move not repeated";
+    }
+
+    return NULL;
+}
+
+
+
+/**
+ * @brief    A display control lost to a NACK is sent again by the next
+ *           lcd_display_ctrl() with the same arguments
+ */
+static const char *run_nack_ctrl(void)
+{
+    const char *fail = probe_lcd();
+
+    if( fail != NULL )
+    {
+        return fail;
+    }
+
+    host_i2c_inject(I2C_SR1_AF, 1);
+    lcd_display_ctrl(1, 1, 0);
+    if( lcd_bus_status() != I2C_ERR_NACK )
+    {
+        return "NACK not reported";
+    }
+
+    lcd_display_ctrl(1, 1, 0);
+    host_i2c_sync();
+
+    if( sim[0].display != 0x06 )
+    {
+        return "display control not repeated";
+    }
+
+    return NULL;
+}
+
+
+
+/**
+ * @brief    A display shift lost to a NACK leaves lcd_shift() unknown
+ *           until lcd_home()
+ */
+static const char *run_nack_shift(void)
+{
+    const char *fail = probe_lcd();
+
+    if( fail != NULL )
+    {
+        return fail;
+    }
+
+    lcd_shift_display(0);
+    lcd_shift_display(0);
+    if( lcd_shift() != 2 )
+    {
+        return "shift not tracked";
+    }
+
+    host_i2c_inject(I2C_SR1_AF, 3);
+    lcd_shift_display(0);
+    if( (lcd_bus_status() != I2C_ERR_NACK) || (lcd_shift() != LCD_SHIFT_UNKNOWN) )
+    {
+        return "shift not unknown after a NACK";
+    }
+
+    lcd_home();
+    host_i2c_sync();
+
+    if( (lcd_shift() != 0) || (sim[0].shift != 0) )
+    {
+        return "lcd_home did not recover the shift";
+    }
+
+    return NULL;
+}
+
+
+
+/**
+ * @brief    A return home lost to a NACK leaves lcd_shift() and the
+ *           cursor unknown, the next lcd_home() is sent
+ */
+static const char *run_nack_home(void)
+{
+    const char *fail = probe_lcd();
+
+    if( fail != NULL )
+    {
+        return fail;
+    }
+
+    lcd_shift_display(0);
+    lcd_goto_xy(2, 5);
+
+    host_i2c_inject(I2C_SR1_AF, 1);
+    lcd_home();
+    if( (lcd_bus_status() != I2C_ERR_NACK) || (lcd_shift() != LCD_SHIFT_UNKNOWN) )
+    {
+        return "shift not unknown after a NACK";
+    }
+
+    lcd_home();
+    host_i2c_sync();
+
+    if( (lcd_shift() != 0) || (sim[0].shift != 0) || (sim[0].ac != 0x00) )
+    {
+        return "lcd_home not repeated";
+    }
+
+    return NULL;
+}
+
+
+
+/**
+ * @brief    Calibrate, store the rate in the flash page and load it back.
+ *           A second calibration to the same rate leaves the page alone.
+ */
+static const char *run_cal_store(void)
+{
+    const char *fail = probe_lcd();
+    uint16_t record = (uint16_t)((lcd_address() << 8) | 40);
+
+    if( fail != NULL )
+    {
+        return fail;
+    }
+    if( lcd_calibrate() != 400000 )
+    {
+        return "not calibrated to 400 kHz";
+    }
+    if( (host_flash_page[0] != record) || (host_flash_page[1] != 0xFFFF) )
+    {
+        return "rate not stored";
+    }
+    if( !(FLASH->CR & FLASH_CR_LOCK) || (FLASH->SR & (FLASH_SR_PGERR | FLASH_SR_WRPRTERR | FLASH_SR_EOP)) )
+    {
+        return "flash left unlocked or flagged";
+    }
+
+    (void)lcd_set_speed(100000);
+    if( !lcd_cal_load() || (lcd_speed() != 400000) )
+    {
+        return "rate not loaded";
+    }
+    if( (lcd_calibrate() != 400000) || (host_flash_page[1] != 0xFFFF) )
+    {
+        return "unchanged rate programmed again";
+    }
+
+    return NULL;
+}
+
+
+
+/**
+ * @brief    Calibrate with the page full, it is erased and the latest
+ *           rates of other addresses written back before the new one
+ */
+static const char *run_cal_full(void)
+{
+    const char *fail = probe_lcd();
+    uint16_t record = (uint16_t)((lcd_address() << 8) | 40);
+    uint16_t n = sizeof(host_flash_page) / sizeof(host_flash_page[0]);
+
+    if( fail != NULL )
+    {
+        return fail;
+    }
+
+    /* Eight other addresses, the last records of each are rate 10 */
+    for(uint16_t i = 0; i < n; i++)
+    {
+        host_flash_page[i] = (uint16_t)(((0x50 + (i % 8)) << 8) | ( (i < (n - 8)) ? 20 : 10 ));
+    }
+
+    if( lcd_calibrate() != 400000 )
+    {
+        return "not calibrated to 400 kHz";
+    }
+
+    for(uint16_t i = 0; i < 8; i++)
+    {
+        if( (host_flash_page[i] & 0xFF) != 10 )
+        {
+            return "latest rates not kept";
+        }
+    }
+    if( (host_flash_page[8] != record) || (host_flash_page[9] != 0xFFFF) )
+    {
+        return "rate not stored after the erase";
+    }
+    if( !(FLASH->CR & FLASH_CR_LOCK) || (FLASH->SR & (FLASH_SR_PGERR | FLASH_SR_WRPRTERR | FLASH_SR_EOP)) )
+    {
+        return "flash left unlocked or flagged";
+    }
+
+    return NULL;
+}
+
+
+
+/**
+ * @brief    A remote master writes to the interrupt slave, a write to
+ *           another address is not acknowledged
+ */
+static const char *run_slave_write(void)
+{
+    uint8_t data[] = { 0x10, 0x11, 0x12, 0x13, 0x14 };
+
+    probe_setup(NULL, 0);
+    slave_writes = 0;
+    i2c_slave_irq_start(&probe_hooks);
+
+    if( (I2C1->CR2 & (I2C_CR2_ITEVTEN | I2C_CR2_ITERREN)) != (I2C_CR2_ITEVTEN | I2C_CR2_ITERREN) )
+    {
+        return "interrupts not enabled";
+    }
+    if( host_i2c_remote(STM32F1_SLV_ADDR, 0, data, sizeof(data), 1) != sizeof(data) )
+    {
+        return "bytes not acknowledged";
+    }
+    if( (slave_writes != 1) || (slave_rx_len != sizeof(data)) || slave_dropped ||
+        (memcmp(slave_rx, data, sizeof(data)) != 0) )
+    {
+        return "write not received";
+    }
+    if( (host_i2c_remote(STM32F1_SLV_ADDR + 1, 0, data, sizeof(data), 1) != 0) || (slave_writes != 1) )
+    {
+        return "other address acknowledged";
+    }
+
+    return NULL;
+}
+
+
+
+/**
+ * @brief    A write longer than I2C_SLAVE_RX_SIZE keeps the first bytes
+ *           and counts the rest as dropped
+ */
+static const char *run_slave_overrun(void)
+{
+    uint8_t data[I2C_SLAVE_RX_SIZE + 10];
+
+    for(uint16_t i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)i;
+    }
+
+    probe_setup(NULL, 0);
+    slave_writes = 0;
+    i2c_slave_irq_start(&probe_hooks);
+
+    if( host_i2c_remote(STM32F1_SLV_ADDR, 0, data, sizeof(data), 1) != sizeof(data) )
+    {
+        return "bytes not acknowledged";
+    }
+    if( (slave_writes != 1) || (slave_rx_len != I2C_SLAVE_RX_SIZE) || (slave_dropped != 10) ||
+        (memcmp(slave_rx, data, I2C_SLAVE_RX_SIZE) != 0) )
+    {
+        return "overrun not counted";
+    }
+
+    return NULL;
+}
+
+
+
+/**
+ * @brief    Write a register address, then read with a repeated START.
+ *           The read runs past the bytes of the transmit hook.
+ */
+static const char *run_slave_read(void)
+{
+    uint8_t reg = 0x02;
+    uint8_t data[6];
+    static const uint8_t expect[] = { 0xA0, 0xA1, 0xA2, 0xA3, 0xFF, 0xFF };
+
+    probe_setup(NULL, 0);
+    slave_writes = 0;
+    i2c_slave_irq_start(&probe_hooks);
+
+    if( host_i2c_remote(STM32F1_SLV_ADDR, 0, &reg, 1, 0) != 1 )
+    {
+        return "register not acknowledged";
+    }
+    if( host_i2c_remote(STM32F1_SLV_ADDR, 1, data, sizeof(data), 1) != sizeof(data) )
+    {
+        return "read not served";
+    }
+    if( (slave_writes != 1) || (slave_rx_len != 1) || (slave_rx[0] != reg) )
+    {
+        return "repeated START did not end the write";
+    }
+    if( (memcmp(data, expect, sizeof(data)) != 0) || (i2c_slave_count() != sizeof(data)) )
+    {
+        return "wrong bytes read";
+    }
+    if( I2C1->CR2 & I2C_CR2_ITBUFEN )
+    {
+        return "NACK not handled";
+    }
+
+    return NULL;
+}
+
+
+
+/**
+ * @brief    This MCU masters a transfer between two slave transfers, the
+ *           interrupt slave is masked meanwhile and armed again after
+ */
+static const char *run_slave_master(void)
+{
+    static const uint8_t addr[] = { 0x27 };
+    uint8_t data[] = { 0x20, 0x21 };
+    uint8_t out = 0x08;
+
+    probe_setup(addr, 1);
+    slave_writes = 0;
+    i2c_slave_irq_start(&probe_hooks);
+
+    if( host_i2c_remote(STM32F1_SLV_ADDR, 0, data, sizeof(data), 1) != sizeof(data) )
+    {
+        return "first slave write failed";
+    }
+    if( i2c_transfer(I2C_BUS_1, 0x27, &out, 1, NULL, 0, 0) != I2C_OK )
+    {
+        return "master write failed";
+    }
+
+    const char *fail = probe_released(2);
+
+    if( fail != NULL )
+    {
+        return fail;
+    }
+    if( (I2C1->CR2 & (I2C_CR2_ITEVTEN | I2C_CR2_ITERREN)) != (I2C_CR2_ITEVTEN | I2C_CR2_ITERREN) )
+    {
+        return "interrupt slave not armed again";
+    }
+    if( (host_i2c_remote(STM32F1_SLV_ADDR, 0, data, sizeof(data), 1) != sizeof(data)) || (slave_writes != 2) )
+    {
+        return "second slave write failed";
+    }
+
+    return NULL;
+}
+
+
+
+#if ( USE_LCD_COP_IRQ )
+
+/**
+ * @brief    A remote master draws through the co-processor register map,
+ *           lcd_cop_process() renders it and STATUS reads back idle
+ */
+static const char *run_cop_render(void)
+{
+    const char *fail = probe_lcd();
+    uint8_t text[] = { LCD_COP_FB, 'H', 'i', ' ', 'c', 'o', 'p' };
+    uint8_t num[] = { LCD_COP_FB + LCD_FB_COLS + 3, '4', '2' };
+    uint8_t ctrl[] = { LCD_COP_CTRL, LCD_COP_CTRL_DISPLAY | LCD_COP_CTRL_CURSOR | LCD_COP_CTRL_BACKLIGHT };
+    uint8_t cursor[] = { LCD_COP_CURSOR, 0x45 };
+    uint8_t reg = LCD_COP_STATUS;
+    uint8_t status = 0;
+    char row[LCD_SIM_COLS + 1];
+
+    if( fail != NULL )
+    {
+        return fail;
+    }
+
+    lcd_cop_init();
+    lcd_cop_process();
+
+    if( (host_i2c_remote(STM32F1_SLV_ADDR, 0, text, sizeof(text), 1) != sizeof(text)) ||
+        (host_i2c_remote(STM32F1_SLV_ADDR, 0, num, sizeof(num), 1) != sizeof(num)) ||
+        (host_i2c_remote(STM32F1_SLV_ADDR, 0, ctrl, sizeof(ctrl), 1) != sizeof(ctrl)) ||
+        (host_i2c_remote(STM32F1_SLV_ADDR, 0, cursor, sizeof(cursor), 1) != sizeof(cursor)) )
+    {
+        return "register write failed";
+    }
+
+    lcd_cop_process();
+    host_i2c_sync();
+
+    lcd_sim_screen(&sim[0], 0, row);
+    if( strncmp(row, "Hi cop", 6) != 0 )
+    {
+        return "row 1 not rendered";
+    }
+    lcd_sim_screen(&sim[0], 1, row);
+    if( strncmp(row, "   42", 5) != 0 )
+    {
+        return "row 2 not rendered";
+    }
+    if( (sim[0].display != 0x06) || (sim[0].ac != 0x45) )
+    {
+        return "cursor not rendered";
+    }
+
+    if( (host_i2c_remote(STM32F1_SLV_ADDR, 0, &reg, 1, 0) != 1) ||
+        (host_i2c_remote(STM32F1_SLV_ADDR, 1, &status, 1, 1) != 1) )
+    {
+        return "STATUS read failed";
+    }
+    if( status & (LCD_COP_ST_BUSY | LCD_COP_ST_ERROR | LCD_COP_ST_OVERRUN) )
+    {
+        return "STATUS not idle";
+    }
+
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,301 @@
+/**
+  ******************************************************************************
+  * @file    replay_main.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   lcdreplay: feeds an I2C capture (i2c_capture.h format) to the
+  *          LCD model, prints the resulting screen and bus statistics and
+  *          checks them against a golden screen and a byte budget.
+  *
+  *          Usage: lcdreplay [-a addr] [-k kHz] [-g golden.txt]
+  *                           [-w golden.txt] [-b bytes] capture.bin
+  *
+  *          -a is the 7-bit LCD address (default LCD_SLAVE_ADDR), -k the SCL
+  *          frequency used for the bus time (default 100). -g compares the
+  *          screen with a golden file, -w writes one. The golden file holds
+  *          one line per LCD row, characters below 0x20 as '?'. -b fails
+  *          the replay when the capture needs more bus bytes, address bytes
+  *          included.
+  *
+  *          Exits with 1 when the screen differs or the budget is exceeded.
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lcd_sim.h"
+#include "i2c_capture.h"
+
+
+/* LCD address used when -a is not given, see lcd.h */
+#define REPLAY_DEFAULT_ADDR         0x27
+
+
+static uint32_t replay_get32(const uint8_t *buf);
+static void replay_screen(const lcdSim_t *sim, char screen[LCD_SIM_ROWS][LCD_SIM_COLS + 1]);
+
+
+
+int main(int argc, char *argv[])
+{
+    const char *capture = NULL;
+    const char *golden = NULL;
+    const char *write_golden = NULL;
+    uint32_t addr = REPLAY_DEFAULT_ADDR;
+    uint32_t khz = 100;
+    long budget = -1;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if( ((i + 1) < argc) && (argv[i][0] == '-') )
+        {
+            const char *opt = argv[i++];
+
+            if( strcmp(opt, "-a") == 0 )
+            {
+                addr = (uint32_t)strtoul(argv[i], NULL, 0);
+            }
+            else if( strcmp(opt, "-k") == 0 )
+            {
+                khz = (uint32_t)atoi(argv[i]);
+            }
+            else if( strcmp(opt, "-g") == 0 )
+            {
+                golden = argv[i];
+            }
+            else if( strcmp(opt, "-w") == 0 )
+            {
+                write_golden = argv[i];
+            }
+            else if( strcmp(opt, "-b") == 0 )
+            {
+                budget = atol(argv[i]);
+            }
+            else
+            {
+                capture = NULL;
+                break;
+            }
+        }
+        else
+        {
+            capture = argv[i];
+        }
+    }
+
+    if( capture == NULL )
+    {
+        fprintf(stderr, "usage: lcdreplay [-a addr] [-k kHz] [-g golden.txt] [-w golden.txt] [-b bytes] capture.bin\n");
+        return 1;
+    }
+    if( khz == 0 )
+    {
+        khz = 100;
+    }
+
+    FILE *in = fopen(capture, "rb");
+    uint8_t header[I2C_CAPTURE_HEADER_LEN];
+
+    if( in == NULL )
+    {
+        perror(capture);
+        return 1;
+    }
+    if( (fread(header, 1, sizeof(header), in) != sizeof(header)) ||
+        (memcmp(header, I2C_CAPTURE_MAGIC, 4) != 0) || (header[4] != I2C_CAPTURE_VERSION) )
+    {
+        fprintf(stderr, "%s: not an I2C capture\n", capture);
+        fclose(in);
+        return 1;
+    }
+
+    uint32_t records = replay_get32(&header[8]);
+    uint32_t lost = replay_get32(&header[12]);
+
+    if( lost )
+    {
+        fprintf(stderr, "warning: %u records were lost, the replay starts mid-session\n", lost);
+    }
+
+    lcdSim_t sim;
+    uint8_t rec[2];
+    uint8_t selected = 0;
+    uint32_t starts = 0, transactions = 0, bytes = 0, clocks = 0;
+
+    lcd_sim_init(&sim);
+
+    for(uint32_t r = 0; (r < records) && (fread(rec, 1, 2, in) == 2); r++)
+    {
+        switch( rec[0] )
+        {
+            case I2C_CAP_START:
+                starts++;
+                clocks += 1;
+                break;
+
+            case I2C_CAP_ADDR:
+                transactions++;
+                bytes++;
+                clocks += 9;
+                selected = ( (uint32_t)(rec[1] >> 1) == addr );
+                break;
+
+            case I2C_CAP_WRITE:
+                bytes++;
+                clocks += 9;
+                if( selected )
+                {
+                    lcd_sim_set_time(&sim, (clocks * 1000000ULL) / khz);
+                    lcd_sim_write(&sim, rec[1]);
+                }
+                break;
+
+            case I2C_CAP_READ:
+                bytes++;
+                clocks += 9;
+                if( selected )
+                {
+                    lcd_sim_set_time(&sim, (clocks * 1000000ULL) / khz);
+                    (void)lcd_sim_read(&sim);
+                }
+                break;
+
+            case I2C_CAP_STOP:
+                clocks += 1;
+                selected = 0;
+                break;
+
+            default:
+                fprintf(stderr, "%s: bad record 0x%02X at %u\n", capture, rec[0], r);
+                fclose(in);
+                return 1;
+        }
+    }
+    fclose(in);
+
+    char screen[LCD_SIM_ROWS][LCD_SIM_COLS + 1];
+
+    replay_screen(&sim, screen);
+
+    printf("+----------------+\n");
+    for(uint8_t row = 0; row < LCD_SIM_ROWS; row++)
+    {
+        printf("|%s|\n", screen[row]);
+    }
+    printf("+----------------+\n");
+    printf("%u records, %u STARTs, %u transactions, %u bytes, %llu us on the bus at %u kHz\n",
+           records, starts, transactions, bytes,
+           (unsigned long long)((clocks * 1000ULL) / khz), khz);
+
+    int status = 0;
+
+    if( write_golden != NULL )
+    {
+        FILE *f = fopen(write_golden, "w");
+
+        if( f == NULL )
+        {
+            perror(write_golden);
+            return 1;
+        }
+        for(uint8_t row = 0; row < LCD_SIM_ROWS; row++)
+        {
+            fprintf(f, "%s\n", screen[row]);
+        }
+        fclose(f);
+    }
+
+    if( golden != NULL )
+    {
+        FILE *f = fopen(golden, "r");
+        char line[LCD_SIM_COLS + 8];
+
+        if( f == NULL )
+        {
+            perror(golden);
+            return 1;
+        }
+        for(uint8_t row = 0; row < LCD_SIM_ROWS; row++)
+        {
+            if( fgets(line, sizeof(line), f) == NULL )
+            {
+                line[0] = '\0';
+            }
+            line[strcspn(line, "\r\n")] = '\0';
+
+            if( strcmp(line, screen[row]) != 0 )
+            {
+                fprintf(stderr, "screen: row %u is \"%s\", golden \"%s\"\n", row + 1, screen[row], line);
+                status = 1;
+            }
+        }
+        fclose(f);
+    }
+
+    if( (budget >= 0) && ((long)bytes > budget) )
+    {
+        fprintf(stderr, "budget: %u bytes, budget %ld\n", bytes, budget);
+        status = 1;
+    }
+
+    return status;
+}
+
+
+
+/**
+ * @brief    Static function to load a little-endian 32-bit value
+ * @param    buf: source
+ * @retval   value
+ */
+static uint32_t replay_get32(const uint8_t *buf)
+{
+    return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+
+
+/**
+ * @brief    Static function to get the printable screen of the model
+ * @param    sim: model
+ * @param    screen: receives one null terminated line per row
+ * @retval   none
+ */
+static void replay_screen(const lcdSim_t *sim, char screen[LCD_SIM_ROWS][LCD_SIM_COLS + 1])
+{
+    for(uint8_t row = 0; row < LCD_SIM_ROWS; row++)
+    {
+        lcd_sim_screen(sim, row, screen[row]);
+        for(uint8_t c = 0; c < LCD_SIM_COLS; c++)
+        {
+            /* CGRAM characters are shown as '?' */
+            if( (uint8_t)screen[row][c] < 0x20 )
+            {
+                screen[row][c] = '?';
+            }
+        }
+    }
+}
@@ -0,0 +1,165 @@
+/**
+  ******************************************************************************
+  * @file    run_main.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   lcdrun: runs the real lcd.c/i2c.c against the host registers with
+  *          the LCD model attached at LCD_SLAVE_ADDR, prints the two given
+  *          lines and shows the resulting screen and bus statistics.
+  *
+  *          Usage: lcdrun [-t swo.bin] [-r capture.bin] [line1 [line2]]
+  *
+  *          -t enables ITM stimulus port LCD_TRACE_PORT and writes the SWO
+  *          stream to swo.bin, for swodecode. Needs USE_LCD_TRACE.
+  *          -r records the I2C transactions to capture.bin, for lcdreplay.
+  *          Needs USE_I2C_CAPTURE.
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include <stdio.h>
+#include <string.h>
+#include "host_regs.h"
+#include "lcd_sim.h"
+#include "lcd.h"
+#include "lcd_trace.h"
+#include "i2c_capture.h"
+
+
+/* The LCD model is a PCF8574 backpack on I2C1, there is no host model of
+   the bit banged bus */
+#if !( USE_LCD_I2C )
+#error "The host tools need USE_LCD_I2C set to 1 in lcd.h"
+#endif
+
+
+int main(int argc, char *argv[])
+{
+    lcdSim_t sim;
+    const char *capture = NULL;
+    int arg = 1;
+
+    host_regs_reset();
+    lcd_sim_init(&sim);
+    host_i2c_attach(LCD_SLAVE_ADDR, lcd_sim_i2c_write, lcd_sim_i2c_read, &sim);
+
+    while( ((arg + 1) < argc) && (argv[arg][0] == '-') )
+    {
+        if( strcmp(argv[arg], "-t") == 0 )
+        {
+            host_swo = fopen(argv[arg + 1], "wb");
+            if( host_swo == NULL )
+            {
+                perror(argv[arg + 1]);
+                return 1;
+            }
+            host_itm.TCR = ITM_TCR_ITMENA_Msk;
+            host_itm.TER = 1UL << LCD_TRACE_PORT;
+        }
+        else if( strcmp(argv[arg], "-r") == 0 )
+        {
+            capture = argv[arg + 1];
+        }
+        else
+        {
+            break;
+        }
+        arg += 2;
+    }
+
+    #if ( USE_LCD_TRACE )
+    lcd_trace_init();
+    #endif
+
+    #if ( USE_I2C_CAPTURE )
+    i2c_capture_start();
+    #endif
+
+    lcd_init();
+
+    if( argc > arg )
+    {
+        lcd_print_string(argv[arg]);
+    }
+    if( argc > (arg + 1) )
+    {
+        lcd_goto_xy(2, 1);
+        lcd_print_string(argv[arg + 1]);
+    }
+    host_i2c_sync();
+
+    if( host_swo != NULL )
+    {
+        fclose(host_swo);
+        host_swo = NULL;
+    }
+
+    if( capture != NULL )
+    {
+        #if ( USE_I2C_CAPTURE )
+        static uint8_t buf[I2C_CAPTURE_HEADER_LEN + I2C_CAPTURE_SIZE];
+        uint32_t len;
+        FILE *f;
+
+        i2c_capture_stop();
+        len = i2c_capture_export(buf, sizeof(buf));
+
+        if( ((f = fopen(capture, "wb")) == NULL) || (fwrite(buf, 1, len, f) != len) )
+        {
+            perror(capture);
+            return 1;
+        }
+        fclose(f);
+        #else
+        fprintf(stderr, "lcdrun: -r needs USE_I2C_CAPTURE\n");
+        return 1;
+        #endif
+    }
+
+    char line[LCD_SIM_COLS + 1];
+
+    printf("+----------------+\n");
+    for(uint8_t row = 0; row < LCD_SIM_ROWS; row++)
+    {
+        lcd_sim_screen(&sim, row, line);
+        printf("|%s|\n", line);
+    }
+    printf("+----------------+\n");
+
+    printf("SCL %u Hz, %u transactions, %u bytes, %u STARTs, %llu us on the bus\n",
+           host_i2c_scl_hz(), host_i2c_stats.transactions, host_i2c_stats.bytes,
+           host_i2c_stats.starts, (unsigned long long)(host_i2c_stats.bus_ns / 1000));
+
+    for(uint8_t k = 0; k < LCD_SIM_VIOL_COUNT; k++)
+    {
+        if( sim.violations[k] )
+        {
+            printf("timing: %u %s violation(s), first at %llu ns\n", sim.violations[k],
+                   lcd_sim_violation_name((lcdSimViolation_t)k),
+                   (unsigned long long)sim.first_violation_ns[k]);
+        }
+    }
+
+    return lcd_sim_violation_total(&sim) ? 2 : 0;
+}
@@ -0,0 +1,134 @@
+/**
+  ******************************************************************************
+  * @file    sim_main.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   lcdsim: feeds a captured PCF8574 byte stream (the bytes written
+  *          by lcd_i2c_cmd(), one per write) to the LCD model and prints the
+  *          resulting screen and bus statistics.
+  *
+  *          Usage: lcdsim [-k kHz] [-s] [stream.bin]
+  *
+  *          The bytes are assumed back to back in one transaction, 9 SCL
+  *          clocks apart at -k kHz (default 100). -s enables the strict
+  *          tAS check. Reads stdin when no file is given.
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lcd_sim.h"
+
+
+int main(int argc, char *argv[])
+{
+    FILE *in = stdin;
+    uint32_t khz = 100;
+    lcdSim_t sim;
+
+    lcd_sim_init(&sim);
+
+    for(int i = 1; i < argc; i++)
+    {
+        if( (strcmp(argv[i], "-k") == 0) && ((i + 1) < argc) )
+        {
+            khz = (uint32_t)atoi(argv[++i]);
+        }
+        else if( strcmp(argv[i], "-s") == 0 )
+        {
+            sim.strict = 1;
+        }
+        else
+        {
+            in = fopen(argv[i], "rb");
+            if( in == NULL )
+            {
+                perror(argv[i]);
+                return 1;
+            }
+        }
+    }
+
+    if( khz == 0 )
+    {
+        khz = 100;
+    }
+
+    uint64_t byte_ns = 9000000ULL / khz;
+    uint64_t t_ns = 0;
+
+    int ch;
+    while( (ch = fgetc(in)) != EOF )
+    {
+        t_ns += byte_ns;
+        lcd_sim_set_time(&sim, t_ns);
+        lcd_sim_write(&sim, (uint8_t)ch);
+    }
+
+    if( in != stdin )
+    {
+        fclose(in);
+    }
+
+    char line[LCD_SIM_COLS + 1];
+
+    printf("+----------------+\n");
+    for(uint8_t row = 0; row < LCD_SIM_ROWS; row++)
+    {
+        lcd_sim_screen(&sim, row, line);
+        for(uint8_t c = 0; c < LCD_SIM_COLS; c++)
+        {
+            /* CGRAM characters are shown as '?' */
+            if( (uint8_t)line[c] < 0x20 )
+            {
+                line[c] = '?';
+            }
+        }
+        printf("|%s|\n", line);
+    }
+    printf("+----------------+\n");
+
+    printf("backlight %s, display %s, cursor %s, blink %s, shift %u\n",
+           lcd_sim_backlight(&sim) ? "on" : "off",
+           (sim.display & 0x04) ? "on" : "off",
+           (sim.display & 0x02) ? "on" : "off",
+           (sim.display & 0x01) ? "on" : "off",
+           sim.shift);
+    printf("port writes %u, instructions %u, data writes %u\n",
+           sim.port_writes, sim.instructions, sim.data_writes);
+
+    for(uint8_t k = 0; k < LCD_SIM_VIOL_COUNT; k++)
+    {
+        if( sim.violations[k] )
+        {
+            printf("timing: %u %s violation(s), first at %llu ns\n", sim.violations[k],
+                   lcd_sim_violation_name((lcdSimViolation_t)k),
+                   (unsigned long long)sim.first_violation_ns[k]);
+        }
+    }
+
+    return lcd_sim_violation_total(&sim) ? 2 : 0;
+}
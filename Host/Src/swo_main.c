@@ -0,0 +1,377 @@
+/**
+  ******************************************************************************
+  * @file    swo_main.c
+  * @author  Marco, Roldan L.
+  * @version v1.0
+  * @date    October 18, 2026
+  * @brief   swodecode: decodes the lcd_trace.h packets of a captured SWO
+  *          stream (raw ITM bytes, e.g. written by OpenOCD "tpiu config
+  *          internal swo.bin uart off ...") into a timeline and latency
+  *          statistics per LCD operation and per I2C transaction.
+  *
+  *          Usage: swodecode [-q] [-f MHz] [-p port] [swo.bin]
+  *
+  *          -q only prints the statistics, -f sets the core clock used to
+  *          convert cycles to us (default 72), -p the stimulus port
+  *          (default LCD_TRACE_PORT). Reads stdin when no file is given.
+  ******************************************************************************
+  *
+  * Copyright (C) 2021  Marco, Roldan L.
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.en.html.
+  *
+  *
+  * https://github.com/rmarco30
+  *
+  ******************************************************************************
+**/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lcd_trace.h"
+
+
+typedef enum
+{
+    OP_CLEAR = 0,
+    OP_HOME,
+    OP_ENTRY,
+    OP_DISPLAY,
+    OP_SHIFT,
+    OP_FUNCTION,
+    OP_CGRAM,
+    OP_DDRAM,
+    OP_CHAR,
+    OP_I2C,
+    OP_COUNT
+} swoOp_t;
+
+
+typedef struct
+{
+    uint32_t count;
+    uint64_t min;
+    uint64_t max;
+    uint64_t sum;
+} swoStat_t;
+
+
+static const char *const op_name[OP_COUNT] =
+{
+    "clear", "home", "entry mode", "display ctrl", "shift", "function set",
+    "set CGRAM", "set DDRAM", "character", "I2C transaction"
+};
+
+
+static const char *const event_name[16] =
+{
+    "?", "START", "ADDR", "WRITE", "READ", "STOP", "INSTR", "DATA", "END",
+    "?", "?", "?", "?", "?", "?", "TIME"
+};
+
+
+static swoStat_t stat[OP_COUNT];
+static uint32_t i2c_bytes = 0;
+static uint32_t packets = 0;
+static uint32_t overflows = 0;
+
+
+static void swo_packet(uint32_t word, uint64_t *now, uint8_t quiet, uint32_t mhz);
+static void swo_stat_add(swoOp_t op, uint64_t cycles);
+static swoOp_t swo_classify(uint8_t instr);
+
+
+
+int main(int argc, char *argv[])
+{
+    FILE *in = stdin;
+    uint8_t quiet = 0;
+    uint32_t mhz = 72;
+    uint32_t port = LCD_TRACE_PORT;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if( strcmp(argv[i], "-q") == 0 )
+        {
+            quiet = 1;
+        }
+        else if( (strcmp(argv[i], "-f") == 0) && ((i + 1) < argc) )
+        {
+            mhz = (uint32_t)atoi(argv[++i]);
+        }
+        else if( (strcmp(argv[i], "-p") == 0) && ((i + 1) < argc) )
+        {
+            port = (uint32_t)atoi(argv[++i]);
+        }
+        else
+        {
+            in = fopen(argv[i], "rb");
+            if( in == NULL )
+            {
+                perror(argv[i]);
+                return 1;
+            }
+        }
+    }
+
+    if( mhz == 0 )
+    {
+        mhz = 72;
+    }
+
+    uint64_t now = 0;
+    int h;
+
+    /* ITM packet stream, ARMv7-M ARM appendix D4 */
+    while( (h = fgetc(in)) != EOF )
+    {
+        if( h & 0x03 )
+        {
+            /* Source packet, payload of 1, 2 or 4 bytes */
+            uint8_t size = ( (h & 0x03) == 3 ) ? 4 : (h & 0x03);
+            uint32_t word = 0;
+            int b = 0;
+
+            for(uint8_t i = 0; (i < size) && ((b = fgetc(in)) != EOF); i++)
+            {
+                word |= (uint32_t)b << (8 * i);
+            }
+            if( b == EOF )
+            {
+                break;
+            }
+
+            /* Software source on our port, 4-byte writes only */
+            if( !(h & 0x04) && ((uint32_t)(h >> 3) == port) && (size == 4) )
+            {
+                swo_packet(word, &now, quiet, mhz);
+            }
+        }
+        else if( h == 0x70 )
+        {
+            overflows++;
+            if( !quiet )
+            {
+                printf("%12s  overflow, packets lost\n", "");
+            }
+        }
+        else if( (h != 0x00) && (h != 0x80) )
+        {
+            /* Timestamp or extension packet, skip its continuation bytes */
+            int b = h;
+            while( (b & 0x80) && ((b = fgetc(in)) != EOF) );
+        }
+    }
+
+    if( in != stdin )
+    {
+        fclose(in);
+    }
+
+    printf("%u packets, %u overflows, %.1f us traced at %u MHz\n", packets, overflows,
+           (double)now / mhz, mhz);
+    printf("%-16s %7s %10s %10s %10s\n", "operation", "count", "min us", "mean us", "max us");
+
+    for(uint8_t op = 0; op < OP_COUNT; op++)
+    {
+        const swoStat_t *s = &stat[op];
+
+        if( s->count )
+        {
+            printf("%-16s %7u %10.1f %10.1f %10.1f\n", op_name[op], s->count,
+                   (double)s->min / mhz, (double)s->sum / s->count / mhz, (double)s->max / mhz);
+        }
+    }
+    if( stat[OP_I2C].count )
+    {
+        printf("%.1f bytes per I2C transaction\n", (double)i2c_bytes / stat[OP_I2C].count);
+    }
+
+    return 0;
+}
+
+
+
+/**
+ * @brief    Static function to decode one trace packet
+ * @param    word: packet
+ * @param    now: cycles since the first packet, advanced by the packet
+ * @param    quiet: 1 to skip the timeline
+ * @param    mhz: core clock
+ * @retval   none
+ */
+static void swo_packet(uint32_t word, uint64_t *now, uint8_t quiet, uint32_t mhz)
+{
+    static uint64_t high = 0;
+    static uint64_t op_start = 0;
+    static int op = -1;
+    static uint64_t i2c_start = 0;
+    static uint8_t i2c_open = 0;
+
+    lcdTraceEvent_t event = (lcdTraceEvent_t)(word >> LCD_TRACE_EVENT_POS);
+    uint8_t data = (word >> LCD_TRACE_DATA_POS) & 0xFF;
+
+    packets++;
+
+    if( event == LCD_TRACE_TIME )
+    {
+        high = (uint64_t)(word & ((1UL << LCD_TRACE_EVENT_POS) - 1)) << LCD_TRACE_DELTA_BITS;
+        return;
+    }
+
+    /* The first packet only sets the origin */
+    if( packets > 1 )
+    {
+        *now += high | (word & LCD_TRACE_DELTA_MASK);
+    }
+    high = 0;
+
+    if( !quiet )
+    {
+        printf("%12.2f  %-5s", (double)*now / mhz, event_name[event]);
+        switch( event )
+        {
+            case LCD_TRACE_I2C_ADDR:
+                printf("  0x%02X %c", data >> 1, (data & 0x01) ? 'R' : 'W');
+                break;
+
+            case LCD_TRACE_I2C_WRITE:
+            case LCD_TRACE_I2C_READ:
+            case LCD_TRACE_LCD_INSTR:
+                printf("  0x%02X", data);
+                break;
+
+            case LCD_TRACE_LCD_DATA:
+                printf("  '%c'", ((data >= 0x20) && (data < 0x7F)) ? data : '?');
+                break;
+
+            default:
+                break;
+        }
+        printf("\n");
+    }
+
+    switch( event )
+    {
+        case LCD_TRACE_LCD_INSTR:
+            op = swo_classify(data);
+            op_start = *now;
+            break;
+
+        case LCD_TRACE_LCD_DATA:
+            op = OP_CHAR;
+            op_start = *now;
+            break;
+
+        case LCD_TRACE_LCD_END:
+            if( op >= 0 )
+            {
+                swo_stat_add((swoOp_t)op, *now - op_start);
+                op = -1;
+            }
+            break;
+
+        case LCD_TRACE_I2C_START:
+            /* A repeated START continues the transaction */
+            if( !i2c_open )
+            {
+                i2c_start = *now;
+                i2c_open = 1;
+            }
+            break;
+
+        case LCD_TRACE_I2C_WRITE:
+        case LCD_TRACE_I2C_READ:
+            i2c_bytes++;
+            break;
+
+        case LCD_TRACE_I2C_STOP:
+            if( i2c_open )
+            {
+                swo_stat_add(OP_I2C, *now - i2c_start);
+                i2c_open = 0;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+
+/**
+ * @brief    Static function to add a latency to an operation
+ * @param    op: operation
+ * @param    cycles: latency
+ * @retval   none
+ */
+static void swo_stat_add(swoOp_t op, uint64_t cycles)
+{
+    swoStat_t *s = &stat[op];
+
+    if( (s->count == 0) || (cycles < s->min) )
+    {
+        s->min = cycles;
+    }
+    if( cycles > s->max )
+    {
+        s->max = cycles;
+    }
+    s->sum += cycles;
+    s->count++;
+}
+
+
+
+/**
+ * @brief    Static function to classify an HD44780 instruction by its
+ *           highest set bit
+ * @param    instr: instruction byte
+ * @retval   operation
+ */
+static swoOp_t swo_classify(uint8_t instr)
+{
+    if( instr & 0x80 )
+    {
+        return OP_DDRAM;
+    }
+    if( instr & 0x40 )
+    {
+        return OP_CGRAM;
+    }
+    if( instr & 0x20 )
+    {
+        return OP_FUNCTION;
+    }
+    if( instr & 0x10 )
+    {
+        return OP_SHIFT;
+    }
+    if( instr & 0x08 )
+    {
+        return OP_DISPLAY;
+    }
+    if( instr & 0x04 )
+    {
+        return OP_ENTRY;
+    }
+    if( instr & 0x02 )
+    {
+        return OP_HOME;
+    }
+    return OP_CLEAR;
+}